@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include "cpp_functions.h"
+#include "prime_table.h"
+#include "scratch.h"
+#include "segmented_sieve.h"
+#include "small_tables.h"
+
+/**
+ * Batch versions of the scalar kernels.
+ * Each one walks a whole input array in a single C++ loop so the Python
+ * call overhead is paid once per batch instead of once per element.
+ */
+
+namespace cpp_functions {
+
+namespace {
+
+int checked_int(std::int64_t value) {
+    if (value < INT_MIN || value > INT_MAX) {
+        throw std::invalid_argument("batch value does not fit in a C int");
+    }
+    return static_cast<int>(value);
+}
+
+} // namespace
+
+void sum_of_squares_batch(const std::int64_t* in, std::int64_t* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = sum_of_squares(in[i]);
+    }
+}
+
+void sum_of_squares_optimized_batch(const std::int64_t* __restrict in,
+                                    std::int64_t* __restrict out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = sum_of_squares_wrapped(in[i]);
+    }
+}
+
+void fibonacci_recursive_batch(const std::int64_t* in, std::int64_t* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = fibonacci_recursive(checked_int(in[i]));
+    }
+}
+
+void fibonacci_memoized_batch(const std::int64_t* in, std::int64_t* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = fibonacci_memoized(checked_int(in[i]));
+    }
+}
+
+void prime_count_batch(const std::int64_t* in, std::int64_t* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = prime_count(checked_int(in[i]));
+    }
+}
+
+void prime_count_optimized_batch(const std::int64_t* in, std::int64_t* out, std::size_t n) {
+    // Small limits come from the compile-time table, larger ones from the
+    // active prime table if it covers them. The rest are answered from a
+    // single sieve sweep: visit the limits in increasing order and read
+    // each one off the segment that contains it
+    const std::shared_ptr<const sieve::PrimeTable> table = sieve::active_table();
+    const std::uint64_t table_limit = table ? table->limit() : 0;
+    scratch::Array<std::size_t> order(n);
+    std::size_t pending = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (in[i] < 2) {
+            out[i] = 0;
+        } else if (in[i] <= small::kPrimeTableLimit) {
+            out[i] = small::kPrimes.count(static_cast<std::uint32_t>(in[i]));
+        } else if (static_cast<std::uint64_t>(in[i]) <= table_limit) {
+            out[i] = static_cast<std::int64_t>(table->count(static_cast<std::uint64_t>(in[i])));
+        } else {
+            order[pending++] = i;
+        }
+    }
+    if (pending == 0) {
+        return;
+    }
+    std::sort(order.data(), order.data() + pending,
+              [in](std::size_t a, std::size_t b) { return in[a] < in[b]; });
+
+    std::uint64_t top = static_cast<std::uint64_t>(in[order[pending - 1]]);
+    sieve::SegmentedSieve sieve(3, top);
+    std::uint64_t running = 1;  // the prime 2
+    std::size_t q = 0;
+    while (q < pending && sieve.next()) {
+        const std::uint8_t* flags = sieve.segment_flags();
+        const std::size_t len = sieve.segment_length();
+        const std::uint64_t low = sieve.segment_low();
+        const std::uint64_t high = low + 2 * static_cast<std::uint64_t>(len - 1);
+
+        std::size_t pos = 0;
+        std::uint64_t partial = 0;
+        for (; q < pending; ++q) {
+            // Segments hold odd values only, so look up the largest odd <= limit
+            std::uint64_t limit = static_cast<std::uint64_t>(in[order[q]]);
+            limit -= 1 - limit % 2;
+            if (limit > high) {
+                break;
+            }
+            std::size_t idx = static_cast<std::size_t>((limit - low) / 2);
+            for (; pos <= idx; ++pos) {
+                partial += flags[pos];
+            }
+            out[order[q]] = static_cast<std::int64_t>(running + partial);
+        }
+        for (; pos < len; ++pos) {
+            partial += flags[pos];
+        }
+        running += partial;
+    }
+}
+
+} // namespace cpp_functions
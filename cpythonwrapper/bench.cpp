@@ -0,0 +1,400 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include "cancellation.h"
+#include "cpp_functions.h"
+#include "gemm.h"
+
+/**
+ * Benchmark harness and the table of kernels it can drive.
+ * Samples are timed with steady_clock around a batch of calls; the batch
+ * size is calibrated once so that a sample lasts at least min_sample_time
+ * and clock resolution does not dominate fast kernels.
+ */
+
+namespace cpp_functions {
+namespace bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** Upper bound on calls per sample, reached only by near-empty bodies. */
+constexpr std::uint64_t kMaxIterations = std::uint64_t(1) << 30;
+
+double time_batch(const std::function<void()>& body, std::uint64_t iterations) {
+    const Clock::time_point start = Clock::now();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        body();
+    }
+    clobber_memory();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/** Calls per sample so that one sample lasts at least min_time. */
+std::uint64_t calibrate(const std::function<void()>& body, double min_time) {
+    std::uint64_t iterations = 1;
+    while (min_time > 0 && iterations < kMaxIterations) {
+        const double elapsed = time_batch(body, iterations);
+        if (elapsed >= min_time) {
+            break;
+        }
+        // Aim 20% past the target; grow at most 10x per round so one
+        // noisy short batch cannot overshoot by orders of magnitude
+        std::uint64_t next = iterations * 10;
+        if (elapsed > 0) {
+            next = std::min(next, static_cast<std::uint64_t>(std::ceil(iterations * min_time * 1.2 / elapsed)));
+        }
+        iterations = std::min(std::max(next, iterations + 1), kMaxIterations);
+    }
+    return iterations;
+}
+
+/** Linear interpolation between closest ranks of a sorted sample. */
+double percentile(const std::vector<double>& sorted, double q) {
+    const double position = q * static_cast<double>(sorted.size() - 1);
+    const std::size_t lower = static_cast<std::size_t>(position);
+    const std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+    const double fraction = position - static_cast<double>(lower);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+}
+
+/**
+ * Body calling fn(arg) through a pointer, with the argument hidden from
+ * the optimiser and the result forced to exist.
+ */
+template <typename R, typename A>
+std::function<void()> scalar_body(R (*fn)(A), A arg) {
+    return [fn, arg] {
+        A input = arg;
+        do_not_optimize(input);
+        R result = fn(input);
+        do_not_optimize(result);
+    };
+}
+
+/** Calls made by fibonacci_recursive(n): 2 F(n + 1) - 1. */
+double fibonacci_calls(long long n) {
+    if (n <= 1) {
+        return 1;
+    }
+    double a = 0;
+    double b = 1;
+    for (long long i = 0; i < n; ++i) {
+        const double next = a + b;
+        a = b;
+        b = next;
+    }
+    return 2 * b - 1;
+}
+
+int int_arg(long long value, const char* name) {
+    if (value < 0 || value > INT32_MAX) {
+        throw std::invalid_argument(std::string("bench: ") + name + " must be a non-negative int");
+    }
+    return static_cast<int>(value);
+}
+
+/**
+ * Square operands of value type T and a body multiplying them with
+ * gemm (cutoff == 0) or gemm_strassen.
+ */
+template <typename T>
+Case matmul_case(long long size_arg, long long threads_arg, long long cutoff) {
+    const std::size_t n = static_cast<std::size_t>(int_arg(size_arg, "size"));
+    const unsigned threads = static_cast<unsigned>(int_arg(threads_arg, "threads"));
+    struct Operands {
+        Matrix<T> a, b, c;
+    };
+    std::shared_ptr<Operands> operands(new Operands{Matrix<T>(n, n), Matrix<T>(n, n), Matrix<T>(n, n)});
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            operands->a(i, j) = static_cast<T>((i + j) % 7);
+            operands->b(i, j) = static_cast<T>((i * j + 1) % 5);
+        }
+    }
+
+    Case c;
+    c.body = [operands, threads, cutoff] {
+        const Matrix<T>& a = operands->a;
+        const Matrix<T>& b = operands->b;
+        if (cutoff > 0) {
+            gemm_strassen<T>(view(a), view(b), view(operands->c), static_cast<std::size_t>(cutoff), threads);
+        } else {
+            gemm<T>(view(a), view(b), view(operands->c), threads);
+        }
+        do_not_optimize(operands->c(0, 0));
+    };
+    c.items = static_cast<double>(n) * n;
+    c.flops = 2.0 * n * n * n;
+    return c;
+}
+
+/**
+ * A benchmarkable kernel: args beyond required take the trailing
+ * defaults, so arity is between required and required + defaults.size().
+ */
+struct Kernel {
+    const char* name;
+    const char* signature;
+    std::size_t required;
+    std::vector<long long> defaults;
+    Case (*make)(const std::vector<long long>& args);
+};
+
+Case sum_of_squares_case(const std::vector<long long>& args) {
+    Case c;
+    c.body = scalar_body(&sum_of_squares, args[0]);
+    c.items = static_cast<double>(std::max(args[0], 0LL));
+    return c;
+}
+
+Case sum_of_squares_optimized_case(const std::vector<long long>& args) {
+    Case c;
+    const long long n = args[0];
+    c.body = [n] {
+        long long input = n;
+        do_not_optimize(input);
+        long long result = sum_of_squares_optimized(input);
+        do_not_optimize(result);
+    };
+    c.items = 1;
+    return c;
+}
+
+Case fibonacci_recursive_case(const std::vector<long long>& args) {
+    Case c;
+    c.body = scalar_body(&fibonacci_recursive, int_arg(args[0], "n"));
+    c.items = fibonacci_calls(args[0]);
+    return c;
+}
+
+Case fibonacci_recursive_parallel_case(const std::vector<long long>& args) {
+    if (args[2] < -1 || args[2] > INT32_MAX) {
+        throw std::invalid_argument("bench: cutoff must be -1 or a non-negative int");
+    }
+    const int n = int_arg(args[0], "n");
+    const int threads = int_arg(args[1], "threads");
+    const int cutoff = static_cast<int>(args[2]);
+    const bool memoize = args[3] != 0;
+    Case c;
+    c.body = [=] {
+        int input = n;
+        do_not_optimize(input);
+        long long result = fibonacci_recursive_parallel(input, threads, cutoff, memoize);
+        do_not_optimize(result);
+    };
+    // Calls of the sequential tree, so rates compare with fibonacci_recursive
+    c.items = fibonacci_calls(args[0]);
+    return c;
+}
+
+Case fibonacci_memoized_case(const std::vector<long long>& args) {
+    Case c;
+    c.body = scalar_body(&fibonacci_memoized, int_arg(args[0], "n"));
+    c.items = 1;
+    return c;
+}
+
+Case fibonacci_mod_case(const std::vector<long long>& args) {
+    if (args[0] < 0 || args[1] < 1) {
+        throw std::invalid_argument("bench: fibonacci_mod needs n >= 0 and mod >= 1");
+    }
+    const unsigned long long n = static_cast<unsigned long long>(args[0]);
+    const unsigned long long mod = static_cast<unsigned long long>(args[1]);
+    Case c;
+    c.body = [n, mod] {
+        unsigned long long input = n;
+        do_not_optimize(input);
+        unsigned long long result = fibonacci_mod(input, mod);
+        do_not_optimize(result);
+    };
+    c.items = 1;
+    return c;
+}
+
+Case prime_count_case(const std::vector<long long>& args) {
+    Case c;
+    c.body = scalar_body(&prime_count, int_arg(args[0], "limit"));
+    c.items = static_cast<double>(args[0]);
+    return c;
+}
+
+Case sieve_case(const std::vector<long long>& args, SieveBackend backend) {
+    const long long limit = args[0];
+    const int threads = int_arg(args[1], "threads");
+    Case c;
+    c.body = [limit, threads, backend] {
+        long long input = limit;
+        do_not_optimize(input);
+        long long result = prime_count_optimized(input, threads, backend);
+        do_not_optimize(result);
+    };
+    c.items = static_cast<double>(std::max(limit, 0LL));
+    return c;
+}
+
+Case prime_count_optimized_case(const std::vector<long long>& args) {
+    return sieve_case(args, SieveBackend::segmented);
+}
+
+Case prime_count_wheel30_case(const std::vector<long long>& args) {
+    return sieve_case(args, SieveBackend::wheel30);
+}
+
+Case prime_pi_case(const std::vector<long long>& args) {
+    Case c;
+    c.body = scalar_body(&prime_pi, args[0]);
+    c.items = static_cast<double>(std::max(args[0], 0LL));
+    return c;
+}
+
+Case matrix_multiplication_case(const std::vector<long long>& args) {
+    const int size = int_arg(args[0], "size");
+    Case c;
+    c.body = [size] {
+        int input = size;
+        do_not_optimize(input);
+        Matrix<int> result = matrix_multiplication(input);
+        do_not_optimize(result.data());
+    };
+    c.items = static_cast<double>(size) * size;
+    c.flops = 2.0 * size * size * size;
+    return c;
+}
+
+Case matmul_int64_case(const std::vector<long long>& args) {
+    return matmul_case<std::int64_t>(args[0], args[1], 0);
+}
+
+Case matmul_float32_case(const std::vector<long long>& args) {
+    return matmul_case<float>(args[0], args[1], 0);
+}
+
+Case matmul_float64_case(const std::vector<long long>& args) {
+    return matmul_case<double>(args[0], args[1], 0);
+}
+
+Case matmul_strassen_float64_case(const std::vector<long long>& args) {
+    if (args[2] < 1) {
+        throw std::invalid_argument("bench: cutoff must be positive");
+    }
+    return matmul_case<double>(args[0], args[1], args[2]);
+}
+
+const std::vector<Kernel>& kernels() {
+    static const std::vector<Kernel> table = {
+        {"sum_of_squares", "n", 1, {}, &sum_of_squares_case},
+        {"sum_of_squares_optimized", "n", 1, {}, &sum_of_squares_optimized_case},
+        {"fibonacci_recursive", "n", 1, {}, &fibonacci_recursive_case},
+        {"fibonacci_recursive_parallel", "n, threads=0, cutoff=-1, memoize=0", 1, {0, -1, 0},
+         &fibonacci_recursive_parallel_case},
+        {"fibonacci_memoized", "n", 1, {}, &fibonacci_memoized_case},
+        {"fibonacci_mod", "n, mod=1000000007", 1, {1000000007}, &fibonacci_mod_case},
+        {"prime_count", "limit", 1, {}, &prime_count_case},
+        {"prime_count_optimized", "limit, threads=1", 1, {1}, &prime_count_optimized_case},
+        {"prime_count_wheel30", "limit, threads=1", 1, {1}, &prime_count_wheel30_case},
+        {"prime_pi", "x", 1, {}, &prime_pi_case},
+        {"matrix_multiplication", "size", 1, {}, &matrix_multiplication_case},
+        {"matmul_int64", "size, threads=1", 1, {1}, &matmul_int64_case},
+        {"matmul_float32", "size, threads=1", 1, {1}, &matmul_float32_case},
+        {"matmul_float64", "size, threads=1", 1, {1}, &matmul_float64_case},
+        {"matmul_strassen_float64", "size, threads=1, cutoff=256", 1,
+         {1, static_cast<long long>(kStrassenCutoff)}, &matmul_strassen_float64_case},
+    };
+    return table;
+}
+
+const Kernel& find_kernel(const std::string& name) {
+    for (const Kernel& kernel : kernels()) {
+        if (name == kernel.name) {
+            return kernel;
+        }
+    }
+    throw std::invalid_argument("bench: unknown kernel '" + name + "'");
+}
+
+} // namespace
+
+Stats measure(const Case& c, const Config& config) {
+    if (!c.body) {
+        throw std::invalid_argument("bench: case has no body");
+    }
+    if (config.repetitions == 0) {
+        throw std::invalid_argument("bench: repetitions must be positive");
+    }
+    for (unsigned i = 0; i < config.warmup; ++i) {
+        c.body();
+    }
+    const std::uint64_t iterations = calibrate(c.body, config.min_sample_time);
+
+    std::vector<double> times;
+    times.reserve(config.repetitions);
+    for (unsigned r = 0; r < config.repetitions; ++r) {
+        cancellation_point();
+        times.push_back(time_batch(c.body, iterations) / static_cast<double>(iterations));
+    }
+    std::sort(times.begin(), times.end());
+
+    Stats stats;
+    stats.samples = times.size();
+    stats.iterations = iterations;
+    stats.min = times.front();
+    stats.max = times.back();
+    double sum = 0;
+    for (double t : times) {
+        sum += t;
+    }
+    stats.mean = sum / static_cast<double>(times.size());
+    double squares = 0;
+    for (double t : times) {
+        squares += (t - stats.mean) * (t - stats.mean);
+    }
+    // Sample standard deviation; a single sample has no spread
+    stats.stddev = times.size() > 1 ? std::sqrt(squares / static_cast<double>(times.size() - 1)) : 0;
+    stats.cv = stats.mean > 0 ? stats.stddev / stats.mean : 0;
+    stats.median = percentile(times, 0.5);
+    stats.p95 = percentile(times, 0.95);
+    stats.p99 = percentile(times, 0.99);
+    if (stats.median > 0) {
+        stats.items_per_second = c.items / stats.median;
+        stats.gflops = c.flops / stats.median * 1e-9;
+    }
+    return stats;
+}
+
+std::vector<std::string> kernel_names() {
+    std::vector<std::string> names;
+    for (const Kernel& kernel : kernels()) {
+        names.push_back(kernel.name);
+    }
+    return names;
+}
+
+std::string kernel_signature(const std::string& name) {
+    return find_kernel(name).signature;
+}
+
+Case make_case(const std::string& name, const std::vector<long long>& args) {
+    const Kernel& kernel = find_kernel(name);
+    if (args.size() < kernel.required || args.size() > kernel.required + kernel.defaults.size()) {
+        throw std::invalid_argument("bench: " + name + " takes (" + kernel.signature + ")");
+    }
+    std::vector<long long> full = args;
+    for (std::size_t i = args.size() - kernel.required; i < kernel.defaults.size(); ++i) {
+        full.push_back(kernel.defaults[i]);
+    }
+    return kernel.make(full);
+}
+
+Stats run(const std::string& name, const std::vector<long long>& args, const Config& config) {
+    return measure(make_case(name, args), config);
+}
+
+} // namespace bench
+} // namespace cpp_functions
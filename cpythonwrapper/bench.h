@@ -0,0 +1,121 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Native benchmark harness for the exported kernels.
+ * Each measurement warms up, calibrates how many calls make one sample,
+ * times a series of samples and reports order statistics over them, so the
+ * numbers are free of Python call overhead and show their spread.
+ */
+
+namespace cpp_functions {
+namespace bench {
+
+/**
+ * Force value to be materialised, so a computation whose result is
+ * otherwise unused cannot be removed or hoisted out of the timed loop.
+ */
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const volatile void* volatile sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * As above, and also make the compiler forget what value holds, so
+ * arguments cannot be constant-folded into the kernel call.
+ */
+template <typename T>
+inline void do_not_optimize(T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#else
+    static const volatile void* volatile sink;
+    sink = &value;
+#endif
+}
+
+/** Compiler barrier: pending stores are assumed to be observed. */
+inline void clobber_memory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+struct Config {
+    unsigned warmup = 1;            // untimed calls before calibration
+    unsigned repetitions = 30;      // timed samples
+    double min_sample_time = 1e-3;  // seconds; short calls are batched up to this
+};
+
+/**
+ * Per-call timings in seconds over the samples of one measurement.
+ */
+struct Stats {
+    std::size_t samples = 0;
+    std::uint64_t iterations = 0;  // calls per sample
+    double min = 0;
+    double max = 0;
+    double mean = 0;
+    double median = 0;
+    double p95 = 0;
+    double p99 = 0;
+    double stddev = 0;
+    double cv = 0;                 // stddev / mean
+    double items_per_second = 0;   // from the median; 0 when items is unset
+    double gflops = 0;             // from the median; 0 when flops is unset
+};
+
+/**
+ * One prepared measurement: body makes a single call, items and flops
+ * describe the work that call does (0 when not meaningful).
+ */
+struct Case {
+    std::function<void()> body;
+    double items = 0;
+    double flops = 0;
+};
+
+/**
+ * Time c.body under config. Between samples it calls cancellation_point(),
+ * so long measurements honour the caller's token.
+ */
+Stats measure(const Case& c, const Config& config);
+
+/**
+ * Names accepted by run(), in registration order.
+ */
+std::vector<std::string> kernel_names();
+
+/**
+ * Usage string for a kernel's arguments, e.g. "n" or "size, threads=1".
+ * Throws std::invalid_argument for an unknown name.
+ */
+std::string kernel_signature(const std::string& name);
+
+/**
+ * Prepare kernel name with args. Inputs (matrices and the like) are built
+ * here, outside the timed region. Throws std::invalid_argument for an
+ * unknown name or a wrong number of arguments.
+ */
+Case make_case(const std::string& name, const std::vector<long long>& args);
+
+/**
+ * make_case followed by measure.
+ */
+Stats run(const std::string& name, const std::vector<long long>& args, const Config& config);
+
+} // namespace bench
+} // namespace cpp_functions
+
+#endif // BENCH_H
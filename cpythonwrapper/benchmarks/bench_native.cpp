@@ -0,0 +1,256 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "cpp_functions.h"
+#include "gemm.h"
+#include "segmented_sieve.h"
+
+/**
+ * Native benchmarks of the cpp_functions kernels on Google Benchmark.
+ * Linked straight against the kernel sources, so no interpreter or binding
+ * overhead reaches the numbers. Run through `make bench-native`, which
+ * writes JSON suitable for diffing across commits.
+ */
+
+namespace {
+
+using namespace cpp_functions;
+
+void BM_SumOfSquares(benchmark::State& state) {
+    const long long n = state.range(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sum_of_squares(n));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetComplexityN(n);
+}
+BENCHMARK(BM_SumOfSquares)->RangeMultiplier(8)->Range(1 << 10, 1 << 21)->Complexity(benchmark::oN);
+
+void BM_SumOfSquaresOptimized(benchmark::State& state) {
+    long long n = state.range(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(n);
+        benchmark::DoNotOptimize(sum_of_squares_optimized(n));
+    }
+}
+BENCHMARK(BM_SumOfSquaresOptimized)->Arg(1000)->Arg(1000000);
+
+void BM_FibonacciRecursive(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fibonacci_recursive(n));
+    }
+}
+BENCHMARK(BM_FibonacciRecursive)->DenseRange(20, 32, 4)->Unit(benchmark::kMicrosecond);
+
+/**
+ * Fork-join scheduling: fib(32) split at cutoff levels over threads
+ * threads. cutoff 0 is the sequential recursion behind one extra call,
+ * so the rows show what each level of forking costs and how it scales.
+ */
+void BM_FibonacciParallel(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(0));
+    const int cutoff = static_cast<int>(state.range(1));
+    const bool memoize = state.range(2) != 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fibonacci_recursive_parallel(32, threads, cutoff, memoize));
+    }
+}
+
+void fork_join_shapes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"threads", "cutoff", "memoize"})->Unit(benchmark::kMillisecond)->UseRealTime();
+    for (long long threads : {1, 2, 4, 0}) {
+        for (long long cutoff : {0, 4, 8, 12}) {
+            b->Args({threads, cutoff, 0});
+        }
+    }
+    b->Args({0, 12, 1});
+}
+BENCHMARK(BM_FibonacciParallel)->Apply(fork_join_shapes);
+
+void BM_FibonacciMemoized(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fibonacci_memoized(n));
+    }
+}
+BENCHMARK(BM_FibonacciMemoized)->Arg(30)->Arg(90);
+
+void BM_FibonacciMod(benchmark::State& state) {
+    const unsigned long long n = static_cast<unsigned long long>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fibonacci_mod(n, 1000000007ULL));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_FibonacciMod)->RangeMultiplier(1 << 10)->Range(1 << 10, std::int64_t(1) << 60)
+    ->Complexity(benchmark::oLogN);
+
+void BM_PrimeCount(benchmark::State& state) {
+    const int limit = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(prime_count(limit));
+    }
+    state.SetItemsProcessed(state.iterations() * limit);
+}
+BENCHMARK(BM_PrimeCount)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Unit(benchmark::kMicrosecond);
+
+/** args: limit, backend (0 = segmented, 1 = wheel30) */
+void BM_PrimeCountOptimized(benchmark::State& state) {
+    const long long limit = state.range(0);
+    const SieveBackend backend = state.range(1) == 0 ? SieveBackend::segmented : SieveBackend::wheel30;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(prime_count_optimized(limit, 1, backend));
+    }
+    state.SetItemsProcessed(state.iterations() * limit);
+    state.SetLabel(backend == SieveBackend::segmented ? "segmented" : "wheel30");
+}
+BENCHMARK(BM_PrimeCountOptimized)
+    ->ArgsProduct({benchmark::CreateRange(1 << 16, 1 << 28, 16), {0, 1}})
+    ->ArgNames({"limit", "backend"})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_PrimePi(benchmark::State& state) {
+    const long long x = state.range(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(prime_pi(x));
+    }
+}
+BENCHMARK(BM_PrimePi)->RangeMultiplier(100)->Range(1000000, 100000000000LL)->Unit(benchmark::kMillisecond);
+
+/**
+ * Segmented sieve over the window of width integers ending at 2^64 - 1,
+ * where a first multiple rounded up past the window would wrap. The count
+ * is checked against is_prime, and the base primes up to 2^32 are built
+ * once outside the timed loop. args: width
+ */
+void BM_SegmentedSieveTopOfRange(benchmark::State& state) {
+    static const std::vector<std::uint32_t> primes = sieve::base_primes(UINT64_MAX);
+    const std::uint64_t hi = UINT64_MAX;
+    const std::uint64_t lo = hi - static_cast<std::uint64_t>(state.range(0) - 1);
+    std::uint64_t expected = 0;
+    for (std::uint64_t x = lo; x >= lo; ++x) {
+        expected += is_prime(x) ? 1 : 0;
+    }
+    std::uint64_t total = 0;
+    for (auto _ : state) {
+        sieve::SegmentedSieve window(lo, hi, primes);
+        total = 0;
+        while (window.next()) {
+            total += window.count();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    if (total != expected) {
+        state.SkipWithError("segmented sieve disagrees with is_prime at the top of the range");
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SegmentedSieveTopOfRange)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
+
+/** args: count, bits (values are uniform below 2^bits) */
+void BM_IsPrimeBatch(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const int bits = static_cast<int>(state.range(1));
+    std::mt19937_64 rng(42);
+    std::vector<std::uint64_t> values(count);
+    for (std::uint64_t& v : values) {
+        v = bits == 64 ? rng() : rng() >> (64 - bits);
+    }
+    std::vector<char> out(count);
+    for (auto _ : state) {
+        is_prime_batch(values.data(), reinterpret_cast<bool*>(out.data()), count);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+BENCHMARK(BM_IsPrimeBatch)->ArgsProduct({{1 << 16}, {32, 48, 64}})->ArgNames({"count", "bits"})
+    ->Unit(benchmark::kMicrosecond);
+
+/** 2 n^3 operations per product, reported as a FLOP/s rate. */
+void set_matmul_counters(benchmark::State& state, long long n) {
+    state.counters["FLOPS"] = benchmark::Counter(2.0 * n * n * n, benchmark::Counter::kIsIterationInvariantRate,
+                                                 benchmark::Counter::kIs1000);
+    state.SetComplexityN(n);
+}
+
+void BM_MatrixMultiplication(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        Matrix<int> result = matrix_multiplication(size);
+        benchmark::DoNotOptimize(result.data());
+    }
+    set_matmul_counters(state, size);
+}
+BENCHMARK(BM_MatrixMultiplication)->RangeMultiplier(2)->Range(32, 512)->Unit(benchmark::kMicrosecond)
+    ->Complexity(benchmark::oNCubed);
+
+/**
+ * Square gemm on operands built outside the timed loop.
+ * args: size, threads, Strassen cutoff (0 = classical kernel)
+ */
+template <typename T>
+void BM_Gemm(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const unsigned threads = static_cast<unsigned>(state.range(1));
+    const std::size_t cutoff = static_cast<std::size_t>(state.range(2));
+    Matrix<T> a(n, n);
+    Matrix<T> b(n, n);
+    Matrix<T> c(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            a(i, j) = static_cast<T>((i + j) % 7);
+            b(i, j) = static_cast<T>((i * j + 1) % 5);
+        }
+    }
+    const Matrix<T>& ca = a;
+    const Matrix<T>& cb = b;
+    for (auto _ : state) {
+        if (cutoff > 0) {
+            gemm_strassen<T>(view(ca), view(cb), view(c), cutoff, threads);
+        } else {
+            gemm<T>(view(ca), view(cb), view(c), threads);
+        }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    set_matmul_counters(state, state.range(0));
+}
+
+void gemm_sizes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"size", "threads", "cutoff"})->Unit(benchmark::kMicrosecond)->UseRealTime();
+    for (long long size = 64; size <= 1024; size *= 2) {
+        b->Args({size, 1, 0});
+    }
+    b->Args({1024, 0, 0});
+}
+
+/** The fixed-size square kernels, with 12 on the reference loop for comparison. */
+void small_gemm_sizes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"size", "threads", "cutoff"});
+    for (long long size : {2, 4, 8, 12, 16}) {
+        b->Args({size, 1, 0});
+    }
+}
+
+void strassen_sizes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"size", "threads", "cutoff"})->Unit(benchmark::kMillisecond)->UseRealTime();
+    for (long long size = 512; size <= 2048; size *= 2) {
+        b->Args({size, 1, static_cast<long long>(kStrassenCutoff)});
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_Gemm, std::int32_t)->Apply(gemm_sizes);
+BENCHMARK_TEMPLATE(BM_Gemm, std::int64_t)->Apply(gemm_sizes);
+BENCHMARK_TEMPLATE(BM_Gemm, float)->Apply(gemm_sizes);
+BENCHMARK_TEMPLATE(BM_Gemm, double)->Apply(gemm_sizes);
+BENCHMARK_TEMPLATE(BM_Gemm, std::int32_t)->Apply(small_gemm_sizes)->Name("BM_GemmSmall<int32_t>");
+BENCHMARK_TEMPLATE(BM_Gemm, double)->Apply(small_gemm_sizes)->Name("BM_GemmSmall<double>");
+BENCHMARK_TEMPLATE(BM_Gemm, double)->Apply(strassen_sizes)->Name("BM_GemmStrassen<double>");
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,76 @@
+#include "cancellation.h"
+
+/**
+ * Cancellation tokens. The flag is a single atomic so any thread can
+ * cancel; the deadline and poll callback are fixed before the work starts
+ * and only read afterwards.
+ */
+
+namespace cpp_functions {
+
+namespace detail {
+thread_local CancellationToken* current_token = nullptr;
+} // namespace detail
+
+namespace {
+
+const char* describe(Cancelled::Reason reason) {
+    switch (reason) {
+    case Cancelled::Reason::deadline:
+        return "operation timed out";
+    case Cancelled::Reason::interrupted:
+        return "operation interrupted";
+    case Cancelled::Reason::cancelled:
+        break;
+    }
+    return "operation cancelled";
+}
+
+} // namespace
+
+Cancelled::Cancelled(Reason reason) : std::runtime_error(describe(reason)), reason_(reason) {}
+
+void CancellationToken::cancel(Cancelled::Reason reason) {
+    int expected = kActive;
+    reason_.compare_exchange_strong(expected, static_cast<int>(reason), std::memory_order_acq_rel);
+}
+
+void CancellationToken::set_deadline(Clock::time_point deadline) {
+    has_deadline_ = true;
+    deadline_ = deadline;
+}
+
+void CancellationToken::set_poll(std::function<void()> poll, std::chrono::milliseconds interval) {
+    poll_ = std::move(poll);
+    poll_thread_ = std::this_thread::get_id();
+    poll_interval_ = interval;
+    next_poll_ = Clock::now() + interval;
+}
+
+bool CancellationToken::stop_requested() {
+    if (reason_.load(std::memory_order_acquire) != kActive) {
+        return true;
+    }
+    if (has_deadline_ || poll_) {
+        const Clock::time_point now = Clock::now();
+        if (has_deadline_ && now >= deadline_) {
+            cancel(Cancelled::Reason::deadline);
+            return true;
+        }
+        if (poll_ && std::this_thread::get_id() == poll_thread_ && now >= next_poll_) {
+            next_poll_ = now + poll_interval_;
+            poll_();
+        }
+    }
+    if (parent_ && parent_->stop_requested()) {
+        cancel(parent_->reason());
+    }
+    return reason_.load(std::memory_order_acquire) != kActive;
+}
+
+Cancelled::Reason CancellationToken::reason() const {
+    int reason = reason_.load(std::memory_order_acquire);
+    return reason == kActive ? Cancelled::Reason::cancelled : static_cast<Cancelled::Reason>(reason);
+}
+
+} // namespace cpp_functions
@@ -0,0 +1,129 @@
+#ifndef CANCELLATION_H
+#define CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * Cooperative cancellation for long-running kernels.
+ * A CancellationScope installs a token for the current thread; kernels call
+ * cancellation_point() at cheap intervals (once per sieve segment, matmul
+ * block or recursion subtree) and it throws Cancelled once the token has
+ * been cancelled or its deadline has passed. parallel_for carries the
+ * caller's token over to the pool threads that help it.
+ */
+
+namespace cpp_functions {
+
+/**
+ * Thrown by cancellation_point() when the installed token has tripped.
+ */
+class Cancelled : public std::runtime_error {
+public:
+    enum class Reason {
+        cancelled,    // CancellationToken::cancel()
+        deadline,     // the timeout expired
+        interrupted,  // the poll callback saw a signal (e.g. Ctrl-C)
+    };
+
+    explicit Cancelled(Reason reason);
+
+    Reason reason() const { return reason_; }
+
+private:
+    Reason reason_;
+};
+
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    CancellationToken() = default;
+
+    /** A token that also trips when parent does; parent must outlive it. */
+    explicit CancellationToken(CancellationToken* parent) : parent_(parent) {}
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    /** Request cancellation; safe from any thread. The first reason wins. */
+    void cancel(Cancelled::Reason reason = Cancelled::Reason::cancelled);
+
+    /** Trip the token once deadline passes. Call before the work starts. */
+    void set_deadline(Clock::time_point deadline);
+
+    /**
+     * Run poll on the calling thread from stop_requested(), at most once per
+     * interval; poll may call cancel(). Other threads never run it. Call
+     * before the work starts.
+     */
+    void set_poll(std::function<void()> poll, std::chrono::milliseconds interval);
+
+    /** True once cancelled, past the deadline, or the parent has tripped. */
+    bool stop_requested();
+
+    /** Why the token tripped; only meaningful once stop_requested() is true. */
+    Cancelled::Reason reason() const;
+
+    /** Throw Cancelled if stop_requested(). */
+    void check() {
+        if (stop_requested()) {
+            throw Cancelled(reason());
+        }
+    }
+
+private:
+    static constexpr int kActive = -1;
+
+    std::atomic<int> reason_{kActive};
+    CancellationToken* parent_ = nullptr;
+    bool has_deadline_ = false;
+    Clock::time_point deadline_;
+    std::function<void()> poll_;
+    std::thread::id poll_thread_;
+    std::chrono::milliseconds poll_interval_{0};
+    Clock::time_point next_poll_;
+};
+
+namespace detail {
+extern thread_local CancellationToken* current_token;
+} // namespace detail
+
+/** Token installed for the calling thread, or nullptr. */
+inline CancellationToken* current_cancellation_token() { return detail::current_token; }
+
+/**
+ * Throw Cancelled if the calling thread's token has tripped. Costs one
+ * thread-local load when no token is installed.
+ */
+inline void cancellation_point() {
+    if (CancellationToken* token = detail::current_token) {
+        token->check();
+    }
+}
+
+/**
+ * Install token for the calling thread for the lifetime of the scope,
+ * restoring the previous one afterwards. token may be nullptr.
+ */
+class CancellationScope {
+public:
+    explicit CancellationScope(CancellationToken* token) : previous_(detail::current_token) {
+        detail::current_token = token;
+    }
+    ~CancellationScope() { detail::current_token = previous_; }
+
+    CancellationScope(const CancellationScope&) = delete;
+    CancellationScope& operator=(const CancellationScope&) = delete;
+
+private:
+    CancellationToken* previous_;
+};
+
+} // namespace cpp_functions
+
+#endif // CANCELLATION_H
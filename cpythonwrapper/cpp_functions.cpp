@@ -1,158 +1,415 @@
-#include <vector>
-#include <cmath>
-
-/**
- * C++ implementation of computationally intensive functions.
- * These functions mirror the Python implementation but are optimized for speed.
- */
-
-namespace cpp_functions {
-
-/**
- * Calculate the sum of squares from 1 to n.
- * C++ version with optimized integer operations.
- */
-long long sum_of_squares(int n) {
-    long long total = 0;
-    for (int i = 1; i <= n; ++i) {
-        total += static_cast<long long>(i) * i;
-    }
-    return total;
-}
-
-/**
- * Calculate the nth Fibonacci number using recursive approach.
- * C++ version with optimized function calls.
- */
-long long fibonacci_recursive(int n) {
-    if (n <= 1) {
-        return n;
-    }
-    return fibonacci_recursive(n - 1) + fibonacci_recursive(n - 2);
-}
-
-/**
- * Count the number of prime numbers up to the given limit.
- * C++ version with optimized trial division.
- */
-int prime_count(int limit) {
-    if (limit < 2) {
-        return 0;
-    }
-    
-    int count = 0;
-    for (int num = 2; num <= limit; ++num) {
-        bool is_prime = true;
-        int sqrt_num = static_cast<int>(std::sqrt(num));
-        
-        for (int i = 2; i <= sqrt_num; ++i) {
-            if (num % i == 0) {
-                is_prime = false;
-                break;
-            }
-        }
-        
-        if (is_prime) {
-            ++count;
-        }
-    }
-    
-    return count;
-}
-
-/**
- * Perform matrix multiplication of two size x size matrices.
- * C++ version with optimized memory access patterns.
- */
-std::vector<std::vector<int>> matrix_multiplication(int size) {
-    // Create two matrices with simple values
-    std::vector<std::vector<int>> matrix_a(size, std::vector<int>(size));
-    std::vector<std::vector<int>> matrix_b(size, std::vector<int>(size));
-    
-    // Initialize matrices
-    for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            matrix_a[i][j] = i + j;
-            matrix_b[i][j] = i * j + 1;
-        }
-    }
-    
-    // Initialize result matrix
-    std::vector<std::vector<int>> result(size, std::vector<int>(size, 0));
-    
-    // Perform matrix multiplication with cache-friendly access pattern
-    for (int i = 0; i < size; ++i) {
-        for (int k = 0; k < size; ++k) {
-            for (int j = 0; j < size; ++j) {
-                result[i][j] += matrix_a[i][k] * matrix_b[k][j];
-            }
-        }
-    }
-    
-    return result;
-}
-
-/**
- * Alternative optimized sum of squares using mathematical formula.
- * This demonstrates how C++ can leverage mathematical optimizations.
- */
-long long sum_of_squares_optimized(int n) {
-    // Using the mathematical formula: sum of squares = n(n+1)(2n+1)/6
-    long long ln = static_cast<long long>(n);
-    return (ln * (ln + 1) * (2 * ln + 1)) / 6;
-}
-
-/**
- * Optimized prime counting using sieve of Eratosthenes.
- * This demonstrates algorithmic optimization possible in C++.
- */
-int prime_count_optimized(int limit) {
-    if (limit < 2) {
-        return 0;
-    }
-    
-    std::vector<bool> is_prime(limit + 1, true);
-    is_prime[0] = is_prime[1] = false;
-    
-    for (int i = 2; i * i <= limit; ++i) {
-        if (is_prime[i]) {
-            for (int j = i * i; j <= limit; j += i) {
-                is_prime[j] = false;
-            }
-        }
-    }
-    
-    int count = 0;
-    for (int i = 2; i <= limit; ++i) {
-        if (is_prime[i]) {
-            ++count;
-        }
-    }
-    
-    return count;
-}
-
-/**
- * Fibonacci with memoization for better performance.
- * Demonstrates how C++ can implement efficient caching.
- */
-long long fibonacci_memoized(int n) {
-    static std::vector<long long> memo;
-    
-    if (memo.size() <= static_cast<size_t>(n)) {
-        memo.resize(n + 1, -1);
-    }
-    
-    if (n <= 1) {
-        return n;
-    }
-    
-    if (memo[n] != -1) {
-        return memo[n];
-    }
-    
-    memo[n] = fibonacci_memoized(n - 1) + fibonacci_memoized(n - 2);
-    return memo[n];
-}
-
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include "cancellation.h"
+#include "cpp_functions.h"
+#include "gemm.h"
+#include "prime_table.h"
+#include "scratch.h"
+#include "segmented_sieve.h"
+#include "small_tables.h"
+#include "thread_pool.h"
+#include "wheel_sieve.h"
+
+/**
+ * C++ implementation of computationally intensive functions.
+ * These functions mirror the Python implementation but are optimized for speed.
+ */
+
+namespace cpp_functions {
+
+namespace {
+
+/** fibonacci_recursive(n) checks for cancellation when n exceeds this. */
+constexpr int kFibonacciCheckDepth = 24;
+
+/** prime_count checks for cancellation once per 65536 candidates. */
+constexpr int kPrimeCountCheckMask = 0xFFFF;
+
+/** fibonacci_recursive_parallel never forks subtrees smaller than this. */
+constexpr int kFibonacciForkMin = 20;
+
+/**
+ * Per-call transposition cache of fibonacci_recursive_parallel: the
+ * value of each subtree some task has finished, indexed by n.
+ */
+class FibonacciSubtreeCache {
+public:
+    explicit FibonacciSubtreeCache(int n) : values_(static_cast<std::size_t>(n) + 1), ready_(values_.size()) {}
+
+    bool find(int n, long long& value) const {
+        if (!ready_[n].load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = values_[n].load(std::memory_order_relaxed);
+        return true;
+    }
+
+    void store(int n, long long value) {
+        values_[n].store(value, std::memory_order_relaxed);
+        ready_[n].store(true, std::memory_order_release);
+    }
+
+private:
+    std::vector<std::atomic<long long>> values_;
+    std::vector<std::atomic<bool>> ready_;
+};
+
+/** The fork-join evaluation shared by every task of one call. */
+struct FibonacciForkJoin {
+    unsigned threads;
+    int cutoff;             // depth at which tasks stop forking
+    FibonacciSubtreeCache* cache;  // null unless memoizing
+
+    long long eval(int n, int depth) const {
+        if (depth >= cutoff || n < kFibonacciForkMin) {
+            return fibonacci_recursive(n);
+        }
+        long long value;
+        if (cache && cache->find(n, value)) {
+            return value;
+        }
+        // Fork: a pool thread takes one subtree unless the caller gets to both first
+        long long halves[2];
+        parallel_for(2, threads, [this, n, depth, &halves](std::size_t i) {
+            halves[i] = eval(n - 1 - static_cast<int>(i), depth + 1);
+        });
+        value = halves[0] + halves[1];
+        if (cache) {
+            cache->store(n, value);
+        }
+        return value;
+    }
+};
+
+} // namespace
+
+/**
+ * Calculate the sum of squares from 1 to n.
+ * C++ version with optimized integer operations.
+ */
+long long sum_of_squares(long long n) {
+    // Checked once up front so the loop itself carries no overflow tests
+    if (n > kSumOfSquaresMax) {
+        throw std::overflow_error("sum_of_squares: result does not fit in 64 bits");
+    }
+    long long total = 0;
+    for (long long i = 1; i <= n; ++i) {
+        total += i * i;
+    }
+    return total;
+}
+
+std::vector<std::uint32_t> sum_of_squares_exact(long long n) {
+    if (n <= 0) {
+        return {};
+    }
+    // Three factors below 2^64 once the 2 and the 3 are divided out: a 192-bit product
+    __int128 reduced[3];
+    sum_of_squares_factors(n, reduced);
+    const std::uint64_t f[3] = {static_cast<std::uint64_t>(reduced[0]), static_cast<std::uint64_t>(reduced[1]),
+                                static_cast<std::uint64_t>(reduced[2])};
+    const unsigned __int128 ab = static_cast<unsigned __int128>(f[0]) * f[1];
+    const unsigned __int128 lo = static_cast<unsigned __int128>(static_cast<std::uint64_t>(ab)) * f[2];
+    const unsigned __int128 hi = static_cast<unsigned __int128>(static_cast<std::uint64_t>(ab >> 64)) * f[2] +
+                                 static_cast<std::uint64_t>(lo >> 64);
+    const std::uint64_t words[3] = {static_cast<std::uint64_t>(lo), static_cast<std::uint64_t>(hi),
+                                    static_cast<std::uint64_t>(hi >> 64)};
+
+    std::vector<std::uint32_t> limbs;
+    for (std::uint64_t word : words) {
+        limbs.push_back(static_cast<std::uint32_t>(word));
+        limbs.push_back(static_cast<std::uint32_t>(word >> 32));
+    }
+    while (!limbs.empty() && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+    return limbs;
+}
+
+/**
+ * Calculate the nth Fibonacci number using recursive approach.
+ * C++ version with optimized function calls.
+ */
+long long fibonacci_recursive(int n) {
+    if (n <= 1) {
+        return n;
+    }
+    // Subtrees below this depth finish in microseconds; only larger ones check
+    if (n > kFibonacciCheckDepth) {
+        cancellation_point();
+    }
+    return fibonacci_recursive(n - 1) + fibonacci_recursive(n - 2);
+}
+
+/**
+ * fibonacci_recursive as a fork-join task tree on the shared pool.
+ * The default cutoff leaves about sixteen leaf tasks per thread, enough
+ * for stealing to even out the unequal subtrees.
+ */
+long long fibonacci_recursive_parallel(int n, int threads, int cutoff, bool memoize) {
+    if (threads < 0) {
+        throw std::invalid_argument("threads must be >= 0");
+    }
+    if (n <= 1) {
+        return n;
+    }
+    const unsigned workers = resolve_threads(static_cast<unsigned>(threads));
+    if (cutoff < 0) {
+        cutoff = 4;
+        for (unsigned t = 1; t < workers; t *= 2) {
+            ++cutoff;
+        }
+    }
+    std::unique_ptr<FibonacciSubtreeCache> cache;
+    if (memoize) {
+        cache = std::make_unique<FibonacciSubtreeCache>(n);
+    }
+    const FibonacciForkJoin tree{workers, cutoff, cache.get()};
+    return tree.eval(n, 0);
+}
+
+/**
+ * Count the number of prime numbers up to the given limit.
+ * C++ version with optimized trial division.
+ */
+int prime_count(int limit) {
+    if (limit < 2) {
+        return 0;
+    }
+    
+    int count = 0;
+    for (int num = 2; num <= limit; ++num) {
+        bool is_prime = true;
+        int sqrt_num = static_cast<int>(std::sqrt(num));
+        
+        for (int i = 2; i <= sqrt_num; ++i) {
+            if (num % i == 0) {
+                is_prime = false;
+                break;
+            }
+        }
+        
+        if (is_prime) {
+            ++count;
+        }
+        if ((num & kPrimeCountCheckMask) == 0) {
+            cancellation_point();
+        }
+    }
+    
+    return count;
+}
+
+namespace {
+
+/** Sizes up to this keep matrix_multiplication's operands on the stack. */
+constexpr std::size_t kStackOperandMax = 16;
+
+/**
+ * Fill the two size x size operands used by matrix_multiplication.
+ */
+template <typename T>
+void fill_operands(const MatrixView<T>& matrix_a, const MatrixView<T>& matrix_b) {
+    const std::size_t n = matrix_a.rows;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            matrix_a(i, j) = static_cast<T>(i + j);
+            matrix_b(i, j) = static_cast<T>(i * j + 1);
+        }
+    }
+}
+
+/**
+ * multiply(a, b, result) on the fill_operands pair of size n. Operands up
+ * to kStackOperandMax live on the stack, larger ones in the thread's
+ * scratch arena, so only the result is freshly allocated.
+ */
+template <typename T, typename Multiply>
+Matrix<T> multiply_operands(std::size_t n, Multiply multiply) {
+    T stack[2 * kStackOperandMax * kStackOperandMax];
+    scratch::Array<T> leased(n > kStackOperandMax ? 2 * n * n : 0);
+    T* storage = n > kStackOperandMax ? leased.data() : stack;
+    const std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(n);
+    fill_operands(MatrixView<T>{storage, n, n, stride, 1}, MatrixView<T>{storage + n * n, n, n, stride, 1});
+
+    // Result matrix starts zeroed
+    Matrix<T> result(n, n);
+    multiply(MatrixView<const T>{storage, n, n, stride, 1},
+             MatrixView<const T>{storage + n * n, n, n, stride, 1}, view(result));
+    return result;
+}
+
+/**
+ * i-k-j multiply that flags signed overflow with the compiler's checked
+ * arithmetic builtins. The flags are OR-ed together so the inner loop has
+ * no branch; each row is tested once when it is finished.
+ */
+void multiply_checked(const MatrixView<const int>& matrix_a, const MatrixView<const int>& matrix_b,
+                      const MatrixView<int>& result) {
+    const std::size_t n = matrix_a.rows;
+    for (std::size_t i = 0; i < n; ++i) {
+        int* c_row = &result(i, 0);
+        const int* a_row = &matrix_a(i, 0);
+        bool overflow = false;
+        for (std::size_t k = 0; k < n; ++k) {
+            const int a_ik = a_row[k];
+            const int* b_row = &matrix_b(k, 0);
+            for (std::size_t j = 0; j < n; ++j) {
+                int product;
+                overflow |= __builtin_mul_overflow(a_ik, b_row[j], &product);
+                overflow |= __builtin_add_overflow(c_row[j], product, &c_row[j]);
+            }
+        }
+        if (overflow) {
+            throw std::overflow_error("matrix_multiplication: int32 accumulator overflowed");
+        }
+    }
+}
+
+template <typename T>
+void multiply_gemm(const MatrixView<const T>& a, const MatrixView<const T>& b, const MatrixView<T>& c) {
+    gemm<T>(a, b, c);
+}
+
+} // namespace
+
+/**
+ * Perform matrix multiplication of two size x size matrices.
+ * C++ version with optimized memory access patterns.
+ */
+Matrix<int> matrix_multiplication(int size, Accumulator accumulator) {
+    if (accumulator != Accumulator::int32 && accumulator != Accumulator::checked) {
+        throw std::invalid_argument("matrix_multiplication: use int32 or checked for an int32 result");
+    }
+    const std::size_t n = size > 0 ? static_cast<std::size_t>(size) : 0;
+    if (accumulator == Accumulator::checked) {
+        return multiply_operands<int>(n, multiply_checked);
+    }
+    // Blocked, register-tiled kernel; wraps on overflow like the plain loop
+    return multiply_operands<int>(n, multiply_gemm<std::int32_t>);
+}
+
+Matrix<std::int64_t> matrix_multiplication_int64(int size) {
+    const std::size_t n = size > 0 ? static_cast<std::size_t>(size) : 0;
+    return multiply_operands<std::int64_t>(n, multiply_gemm<std::int64_t>);
+}
+
+/**
+ * Alternative optimized sum of squares using mathematical formula.
+ * This demonstrates how C++ can leverage mathematical optimizations.
+ */
+long long sum_of_squares_optimized(long long n, Accumulator accumulator) {
+    // Using the mathematical formula: sum of squares = n(n+1)(2n+1)/6
+    switch (accumulator) {
+    case Accumulator::int64:
+        return sum_of_squares_wrapped(n);
+    case Accumulator::checked: {
+        // Dividing first leaves only products no larger than the result to check
+        __int128 f[3];
+        sum_of_squares_factors(n, f);
+        long long partial;
+        long long product;
+        if (__builtin_mul_overflow(f[0], f[1], &partial) || __builtin_mul_overflow(partial, f[2], &product)) {
+            throw std::overflow_error("sum_of_squares_optimized: int64 accumulator overflowed");
+        }
+        return product;
+    }
+    case Accumulator::int128: {
+        __int128 wide = n;
+        __int128 product;
+        if (__builtin_mul_overflow(wide * (wide + 1), 2 * wide + 1, &product) ||
+            product / 6 > INT64_MAX || product / 6 < INT64_MIN) {
+            throw std::overflow_error("sum_of_squares_optimized: result does not fit in 64 bits");
+        }
+        return static_cast<long long>(product / 6);
+    }
+    case Accumulator::int32:
+        break;
+    }
+    throw std::invalid_argument("sum_of_squares_optimized: use int64, int128 or checked");
+}
+
+/**
+ * Optimized prime counting using sieve of Eratosthenes.
+ * Runs the segmented, odd-only sieve so memory stays O(sqrt(limit)) and each
+ * segment stays resident in cache however large the limit grows. Limits the
+ * active prime table covers are a block count plus a few popcounts.
+ */
+long long prime_count_optimized(long long limit, int threads, SieveBackend backend) {
+    if (threads < 0) {
+        throw std::invalid_argument("threads must be >= 0");
+    }
+    if (limit < 2) {
+        return 0;
+    }
+    if (limit <= small::kPrimeTableLimit) {
+        return small::kPrimes.count(static_cast<std::uint32_t>(limit));
+    }
+    
+    std::uint64_t hi = static_cast<std::uint64_t>(limit);
+    const std::shared_ptr<const sieve::PrimeTable> table = sieve::active_table();
+    if (table && hi <= table->limit()) {
+        return static_cast<long long>(table->count(hi));
+    }
+    unsigned workers = static_cast<unsigned>(threads);
+    if (backend == SieveBackend::wheel30) {
+        return static_cast<long long>(sieve::count_primes_wheel(2, hi, workers));
+    }
+    return static_cast<long long>(sieve::count_primes_parallel(2, hi, workers));
+}
+
+namespace {
+
+/**
+ * Hit and miss counters of the Fibonacci table. The table itself is
+ * small::kFibonacci, fixed at compile time, so only these are shared.
+ */
+struct FibonacciCache {
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+};
+
+FibonacciCache g_fibonacci_cache;
+
+} // namespace
+
+/**
+ * Fibonacci with memoization for better performance.
+ * Every value that fits is precomputed at compile time (small_tables.h),
+ * so a call is one table load and needs no lock.
+ */
+long long fibonacci_memoized(int n) {
+    if (n <= 1) {
+        return n;
+    }
+    if (n <= small::kFibonacciMax) {
+        g_fibonacci_cache.hits.fetch_add(1, std::memory_order_relaxed);
+        return small::kFibonacci[n];
+    }
+    g_fibonacci_cache.misses.fetch_add(1, std::memory_order_relaxed);
+    // Past F(92) the result has wrapped; fast doubling gets the same bits in O(log n)
+    return static_cast<long long>(fibonacci_wrapped(static_cast<unsigned long long>(n)));
+}
+
+CacheStats fibonacci_cache_stats() {
+    CacheStats stats;
+    stats.entries = small::kFibonacciMax + 1;
+    stats.capacity = small::kFibonacciMax + 1;
+    stats.hits = g_fibonacci_cache.hits.load(std::memory_order_relaxed);
+    stats.misses = g_fibonacci_cache.misses.load(std::memory_order_relaxed);
+    stats.bytes = sizeof(small::kFibonacci);
+    return stats;
+}
+
+void clear_caches() {
+    // The table is a compile-time constant, so only its counters are reset
+    g_fibonacci_cache.hits.store(0, std::memory_order_relaxed);
+    g_fibonacci_cache.misses.store(0, std::memory_order_relaxed);
+}
+
 } // namespace cpp_functions
\ No newline at end of file
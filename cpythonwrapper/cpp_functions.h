@@ -1,50 +1,208 @@
-#ifndef CPP_FUNCTIONS_H
-#define CPP_FUNCTIONS_H
-
-#include <vector>
-
-/**
- * Header file for C++ implementation of computationally intensive functions.
- * These functions provide high-performance alternatives to Python implementations.
- */
-
-namespace cpp_functions {
-
-/**
- * Calculate the sum of squares from 1 to n.
- */
-long long sum_of_squares(int n);
-
-/**
- * Calculate the nth Fibonacci number using recursive approach.
- */
-long long fibonacci_recursive(int n);
-
-/**
- * Count the number of prime numbers up to the given limit.
- */
-int prime_count(int limit);
-
-/**
- * Perform matrix multiplication of two size x size matrices.
- */
-std::vector<std::vector<int>> matrix_multiplication(int size);
-
-/**
- * Optimized sum of squares using mathematical formula.
- */
-long long sum_of_squares_optimized(int n);
-
-/**
- * Optimized prime counting using sieve of Eratosthenes.
- */
-int prime_count_optimized(int limit);
-
-/**
- * Fibonacci with memoization for better performance.
- */
-long long fibonacci_memoized(int n);
-
-} // namespace cpp_functions
-
+#ifndef CPP_FUNCTIONS_H
+#define CPP_FUNCTIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "matrix.h"
+
+/**
+ * Header file for C++ implementation of computationally intensive functions.
+ * These functions provide high-performance alternatives to Python implementations.
+ */
+
+namespace cpp_functions {
+
+/**
+ * Arithmetic used by kernels whose results can outgrow their natural width.
+ */
+enum class Accumulator {
+    int32,    // 32-bit, wraps on overflow
+    int64,    // 64-bit, wraps on overflow
+    int128,   // 128-bit intermediates; the result must still fit in 64 bits
+    checked,  // native width; overflow throws std::overflow_error
+};
+
+/** Largest n whose sum of squares fits in a signed 64-bit integer. */
+constexpr long long kSumOfSquaresMax = 3024616;
+
+/**
+ * Calculate the sum of squares from 1 to n.
+ * Throws std::overflow_error when n > kSumOfSquaresMax.
+ */
+long long sum_of_squares(long long n);
+
+/**
+ * Exact sum of squares from 1 to n for any 64-bit n, as little-endian
+ * base 2^32 limbs (the value needs up to 190 bits).
+ */
+std::vector<std::uint32_t> sum_of_squares_exact(long long n);
+
+/**
+ * Calculate the nth Fibonacci number using recursive approach.
+ */
+long long fibonacci_recursive(int n);
+
+/**
+ * fibonacci_recursive with the call tree split into tasks: calls fewer
+ * than cutoff levels deep (and with n >= 20) fork their two subtrees onto
+ * the shared pool, deeper ones run the sequential recursion. threads caps
+ * the pool threads used (0 = all); cutoff < 0 picks log2(threads) + 4.
+ * memoize shares a per-call cache of finished forked subtrees, so a
+ * subtree repeated above the cutoff is normally evaluated once. Returns
+ * fibonacci_recursive(n); a benchmark of fork-join scheduling overhead.
+ */
+long long fibonacci_recursive_parallel(int n, int threads = 0, int cutoff = -1, bool memoize = false);
+
+/**
+ * Count the number of prime numbers up to the given limit.
+ */
+int prime_count(int limit);
+
+/**
+ * Perform matrix multiplication of two size x size matrices.
+ * The result is one contiguous row-major buffer. accumulator is int32
+ * (wraps; blocked kernel) or checked (throws std::overflow_error).
+ */
+Matrix<int> matrix_multiplication(int size, Accumulator accumulator = Accumulator::int32);
+
+/**
+ * matrix_multiplication with 64-bit operands and accumulation. Exact for
+ * every size whose operands fit in memory (entries stay below 2 size^4).
+ */
+Matrix<std::int64_t> matrix_multiplication_int64(int size);
+
+/**
+ * n, n + 1 and 2n + 1 with the 2 and the 3 of n(n+1)(2n+1)/6 divided out
+ * of whichever factor they divide. Their product is the sum of squares
+ * with no division left, so it is exact whenever the result fits.
+ */
+inline void sum_of_squares_factors(long long n, __int128 (&f)[3]) {
+    f[0] = n;
+    f[1] = static_cast<__int128>(n) + 1;
+    f[2] = 2 * static_cast<__int128>(n) + 1;
+    f[f[0] % 2 == 0 ? 0 : 1] /= 2;
+    f[f[0] % 3 == 0 ? 0 : (f[1] % 3 == 0 ? 1 : 2)] /= 3;
+}
+
+/**
+ * Optimized sum of squares using mathematical formula.
+ * accumulator is int64 (exact up to kSumOfSquaresMax, wraps modulo 2^64
+ * past it), checked (throws std::overflow_error past it) or int128 (the
+ * same result as checked, from 128-bit intermediates).
+ */
+long long sum_of_squares_optimized(long long n, Accumulator accumulator = Accumulator::int64);
+
+/** sum_of_squares_optimized with the int64 accumulator. */
+inline long long sum_of_squares_wrapped(long long n) {
+    // Halve the even one of n and n + 1, then divide the product by 3 by
+    // multiplying with 3^-1 mod 2^64: exact because 3 divides it, and
+    // branch-free unsigned arithmetic that wraps instead of invoking UB
+    const std::uint64_t un = static_cast<std::uint64_t>(n);
+    const std::uint64_t half = static_cast<std::uint64_t>(n >> 1) + (un & 1);
+    const std::uint64_t other = un + 1 - (un & 1);
+    return static_cast<long long>(half * other * (2 * un + 1) * 0xAAAAAAAAAAAAAAABull);
+}
+
+/**
+ * Storage layouts available to prime_count_optimized.
+ */
+enum class SieveBackend {
+    segmented,  // one byte per odd number
+    wheel30,    // one bit per integer coprime to 30, counted with popcount
+};
+
+/**
+ * Optimized prime counting using a segmented sieve of Eratosthenes.
+ * Accepts 64-bit limits; memory use is O(sqrt(limit)).
+ * threads > 1 splits the range across worker threads; 0 uses every core.
+ */
+long long prime_count_optimized(long long limit, int threads = 1,
+                                SieveBackend backend = SieveBackend::segmented);
+
+/**
+ * Count primes <= x using the Meissel-Lehmer method.
+ * Sublinear (O(x^(2/3))) so 64-bit x in the 1e11-1e13 range is practical.
+ */
+long long prime_pi(long long x);
+
+/**
+ * Fibonacci with memoization for better performance.
+ * F(0) .. F(92) come from a compile-time table; larger n wraps modulo 2^64
+ * and is computed by fibonacci_wrapped in O(log n).
+ */
+long long fibonacci_memoized(int n);
+
+/**
+ * Occupancy and hit counters of a memo cache.
+ */
+struct CacheStats {
+    std::size_t entries = 0;
+    std::size_t capacity = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::size_t bytes = 0;
+};
+
+/**
+ * Statistics of the fibonacci_memoized cache.
+ */
+CacheStats fibonacci_cache_stats();
+
+/**
+ * Reset the hit and miss counters of every memo cache. The Fibonacci table
+ * is a compile-time constant, so there is nothing to evict.
+ */
+void clear_caches();
+
+/**
+ * F(n) mod m using fast doubling in O(log n) with 128-bit products.
+ */
+unsigned long long fibonacci_mod(unsigned long long n, unsigned long long mod);
+
+/**
+ * F(n) mod 2^64 using fast doubling in O(log n) with wrapping products.
+ */
+unsigned long long fibonacci_wrapped(unsigned long long n);
+
+/**
+ * Exact F(n) using fast doubling, as little-endian base 2^32 limbs.
+ */
+std::vector<std::uint32_t> fibonacci_big(unsigned long long n);
+
+/**
+ * Batch kernels: out[i] = f(in[i]) for i < n, evaluated in one C++ loop.
+ * The sum of squares kernels accept every int64 like their scalar forms:
+ * sum_of_squares_batch throws std::overflow_error past kSumOfSquaresMax
+ * and sum_of_squares_optimized_batch wraps. The others throw
+ * std::invalid_argument on values that do not fit their scalar
+ * function's int parameter.
+ */
+void sum_of_squares_batch(const std::int64_t* in, std::int64_t* out, std::size_t n);
+void sum_of_squares_optimized_batch(const std::int64_t* in, std::int64_t* out, std::size_t n);
+void fibonacci_recursive_batch(const std::int64_t* in, std::int64_t* out, std::size_t n);
+void fibonacci_memoized_batch(const std::int64_t* in, std::int64_t* out, std::size_t n);
+void prime_count_batch(const std::int64_t* in, std::int64_t* out, std::size_t n);
+
+/**
+ * Batch prime_count_optimized: all limits are answered from one sieve
+ * sweep up to the largest limit.
+ */
+void prime_count_optimized_batch(const std::int64_t* in, std::int64_t* out, std::size_t n);
+
+/**
+ * Deterministic primality test for any 64-bit n: a table lookup up to 65536
+ * or inside the active prime table (prime_table.h), otherwise a small-prime
+ * screen and Miller-Rabin with at most seven bases.
+ */
+bool is_prime(std::uint64_t n);
+
+/**
+ * out[i] = is_prime(in[i]). Values that survive the screen are tested
+ * several at a time so their multiply chains overlap.
+ */
+void is_prime_batch(const std::uint64_t* in, bool* out, std::size_t n);
+
+} // namespace cpp_functions
+
 #endif // CPP_FUNCTIONS_H
\ No newline at end of file
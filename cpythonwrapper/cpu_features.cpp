@@ -0,0 +1,153 @@
+#include "cpu_features.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(CPP_FUNCTIONS_X86)
+#include <cpuid.h>
+#elif defined(CPP_FUNCTIONS_AARCH64) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace cpp_functions {
+
+namespace {
+
+const char* const kPathNames[] = {"generic", "sse42", "avx2", "avx512", "neon"};
+
+#if defined(CPP_FUNCTIONS_X86)
+
+/** XCR0: which register states the OS saves on a context switch. */
+std::uint64_t xgetbv0() {
+    std::uint32_t eax, edx;
+    // Raw opcode so the baseline build needs no -mxsave
+    __asm__ volatile(".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<std::uint64_t>(edx) << 32) | eax;
+}
+
+CpuFeatures detect() {
+    CpuFeatures f;
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return f;
+    }
+    f.sse42 = (ecx & (1u << 20)) != 0;
+    f.popcnt = (ecx & (1u << 23)) != 0;
+    const bool avx = (ecx & (1u << 28)) != 0;
+    const bool fma = (ecx & (1u << 12)) != 0;
+    const bool osxsave = (ecx & (1u << 27)) != 0;
+    if (!osxsave || !avx) {
+        return f;
+    }
+    // AVX needs the XMM and YMM states saved, AVX-512 also opmask and ZMM
+    const std::uint64_t xcr0 = xgetbv0();
+    const bool ymm_state = (xcr0 & 0x6) == 0x6;
+    const bool zmm_state = (xcr0 & 0xe6) == 0xe6;
+    if (!ymm_state || __get_cpuid_max(0, nullptr) < 7) {
+        return f;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    f.avx2 = (ebx & (1u << 5)) != 0;
+    f.fma = fma;
+    f.avx512f = zmm_state && (ebx & (1u << 16)) != 0;
+    return f;
+}
+
+SimdPath widest(const CpuFeatures& f) {
+    if (f.avx512f && f.avx2 && f.fma) {
+        return SimdPath::avx512;
+    }
+    if (f.avx2 && f.fma) {
+        return SimdPath::avx2;
+    }
+    if (f.sse42 && f.popcnt) {
+        return SimdPath::sse42;
+    }
+    return SimdPath::generic;
+}
+
+#elif defined(CPP_FUNCTIONS_AARCH64)
+
+CpuFeatures detect() {
+    CpuFeatures f;
+    // Advanced SIMD is part of the AArch64 baseline
+    f.neon = true;
+#if defined(__linux__) && defined(HWCAP_SVE)
+    f.sve = (getauxval(AT_HWCAP) & HWCAP_SVE) != 0;
+#endif
+    return f;
+}
+
+SimdPath widest(const CpuFeatures&) {
+    return SimdPath::neon;
+}
+
+#else
+
+CpuFeatures detect() {
+    return CpuFeatures();
+}
+
+SimdPath widest(const CpuFeatures&) {
+    return SimdPath::generic;
+}
+
+#endif
+
+/** Paths run on the same architecture, so a narrower one is always safe. */
+bool runs_on(SimdPath path, SimdPath widest_path) {
+    if (path == SimdPath::generic) {
+        return true;
+    }
+    if (widest_path == SimdPath::neon) {
+        return path == SimdPath::neon;
+    }
+    return widest_path != SimdPath::neon && path <= widest_path;
+}
+
+SimdPath select_path() {
+    const SimdPath best = widest(cpu_features());
+    const char* requested = std::getenv("CPP_ACCELERATED_SIMD");
+    if (!requested) {
+        return best;
+    }
+    for (int i = 0; i <= static_cast<int>(SimdPath::neon); ++i) {
+        const SimdPath path = static_cast<SimdPath>(i);
+        if (std::strcmp(requested, kPathNames[i]) == 0 && runs_on(path, best)) {
+            return path;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+SimdPath simd_path() {
+    static const SimdPath path = select_path();
+    return path;
+}
+
+const char* simd_path_name(SimdPath path) {
+    return kPathNames[static_cast<int>(path)];
+}
+
+const char* cpu_arch() {
+#if defined(__x86_64__)
+    return "x86_64";
+#elif defined(__i386__)
+    return "x86";
+#elif defined(__aarch64__)
+    return "aarch64";
+#else
+    return "other";
+#endif
+}
+
+} // namespace cpp_functions
@@ -0,0 +1,62 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+/**
+ * Runtime CPU feature detection.
+ * The extension is compiled for the baseline ISA of its platform; kernels
+ * that profit from wider vectors are compiled a second or third time with
+ * a function-level target attribute and picked once, at import, from what
+ * cpuid (x86) or the auxiliary vector (ARM Linux) reports. One build thus
+ * runs everywhere and still uses AVX2 or AVX-512 where they exist.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CPP_FUNCTIONS_X86 1
+#define CPP_FUNCTIONS_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define CPP_FUNCTIONS_TARGET_AVX2 __attribute__((target("avx2,fma,popcnt")))
+#define CPP_FUNCTIONS_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma,popcnt")))
+#elif defined(__aarch64__)
+#define CPP_FUNCTIONS_AARCH64 1
+#endif
+
+namespace cpp_functions {
+
+/** Extensions the CPU and operating system both support. */
+struct CpuFeatures {
+    bool sse42 = false;
+    bool popcnt = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool avx512f = false;
+    bool neon = false;
+    bool sve = false;
+};
+
+/** Kernel families, narrowest first within each architecture. */
+enum class SimdPath {
+    generic,   // baseline ISA only
+    sse42,     // SSE4.2 + POPCNT
+    avx2,      // AVX2 + FMA
+    avx512,    // AVX-512F
+    neon,      // AArch64 Advanced SIMD
+};
+
+/** Features of the running CPU, detected on first use. */
+const CpuFeatures& cpu_features();
+
+/**
+ * Widest path this build can run on this CPU. The environment variable
+ * CPP_ACCELERATED_SIMD=<name> narrows it (e.g. to compare kernels); names
+ * the CPU cannot run are ignored. Fixed on first use.
+ */
+SimdPath simd_path();
+
+/** Lower-case name of path ("generic", "sse42", "avx2", "avx512", "neon"). */
+const char* simd_path_name(SimdPath path);
+
+/** Architecture this build targets: "x86_64", "x86", "aarch64" or "other". */
+const char* cpu_arch();
+
+} // namespace cpp_functions
+
+#endif // CPU_FEATURES_H
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "cpp_functions.h"
+#include "small_tables.h"
+
+/**
+ * Fast-doubling Fibonacci.
+ * F(2k) = F(k) * (2 F(k+1) - F(k)) and F(2k+1) = F(k)^2 + F(k+1)^2 give F(n)
+ * in O(log n) steps, either modulo a 64-bit m or exactly with big integers.
+ */
+
+namespace cpp_functions {
+
+namespace {
+
+using Limbs = std::vector<std::uint32_t>;  // little-endian base 2^32
+
+/** Below this many limbs schoolbook multiplication beats Karatsuba. */
+constexpr std::size_t kKaratsubaCutoff = 40;
+
+std::uint64_t mul_mod(std::uint64_t a, std::uint64_t b, std::uint64_t m) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<std::uint64_t>(
+        static_cast<unsigned __int128>(a) * b % m);
+#else
+    // Double-and-add keeps every intermediate below 2 * m
+    std::uint64_t result = 0;
+    a %= m;
+    while (b > 0) {
+        if (b & 1) {
+            result = (result >= m - a) ? result - (m - a) : result + a;
+        }
+        a = (a >= m - a) ? a - (m - a) : a + a;
+        b >>= 1;
+    }
+    return result;
+#endif
+}
+
+void trim(Limbs& x) {
+    while (!x.empty() && x.back() == 0) {
+        x.pop_back();
+    }
+}
+
+/** x += y << (32 * offset) */
+void add_into(Limbs& x, const std::uint32_t* y, std::size_t ny, std::size_t offset = 0) {
+    if (x.size() < offset + ny + 1) {
+        x.resize(offset + ny + 1, 0);
+    }
+    std::uint64_t carry = 0;
+    std::size_t i = 0;
+    for (; i < ny; ++i) {
+        std::uint64_t sum = static_cast<std::uint64_t>(x[offset + i]) + y[i] + carry;
+        x[offset + i] = static_cast<std::uint32_t>(sum);
+        carry = sum >> 32;
+    }
+    for (std::size_t k = offset + i; carry != 0; ++k) {
+        if (k == x.size()) {
+            x.push_back(0);
+        }
+        std::uint64_t sum = static_cast<std::uint64_t>(x[k]) + carry;
+        x[k] = static_cast<std::uint32_t>(sum);
+        carry = sum >> 32;
+    }
+}
+
+Limbs add(const Limbs& a, const Limbs& b) {
+    Limbs result(a);
+    add_into(result, b.data(), b.size());
+    trim(result);
+    return result;
+}
+
+/** x -= y, requires x >= y */
+void sub_from(Limbs& x, const Limbs& y) {
+    std::int64_t borrow = 0;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        std::int64_t diff = static_cast<std::int64_t>(x[i]) - borrow -
+                            (i < y.size() ? static_cast<std::int64_t>(y[i]) : 0);
+        borrow = diff < 0 ? 1 : 0;
+        x[i] = static_cast<std::uint32_t>(diff + (borrow << 32));
+        if (i >= y.size() && borrow == 0) {
+            break;
+        }
+    }
+    trim(x);
+}
+
+void mul_schoolbook(const std::uint32_t* a, std::size_t na,
+                    const std::uint32_t* b, std::size_t nb, std::uint32_t* out) {
+    std::fill(out, out + na + nb, 0u);
+    for (std::size_t i = 0; i < na; ++i) {
+        std::uint64_t carry = 0;
+        const std::uint64_t ai = a[i];
+        for (std::size_t j = 0; j < nb; ++j) {
+            std::uint64_t cur = ai * b[j] + out[i + j] + carry;
+            out[i + j] = static_cast<std::uint32_t>(cur);
+            carry = cur >> 32;
+        }
+        out[i + nb] = static_cast<std::uint32_t>(carry);
+    }
+}
+
+Limbs mul(const Limbs& a, const Limbs& b);
+
+Limbs karatsuba(const Limbs& a, const Limbs& b) {
+    // a = a1 * B^m + a0, b = b1 * B^m + b0
+    const std::size_t m = std::max(a.size(), b.size()) / 2;
+    auto split = [m](const Limbs& x, Limbs& lo, Limbs& hi) {
+        std::size_t cut = std::min(m, x.size());
+        lo.assign(x.begin(), x.begin() + cut);
+        hi.assign(x.begin() + cut, x.end());
+        trim(lo);
+    };
+    Limbs a0, a1, b0, b1;
+    split(a, a0, a1);
+    split(b, b0, b1);
+
+    Limbs z0 = mul(a0, b0);
+    Limbs z2 = mul(a1, b1);
+    Limbs z1 = mul(add(a0, a1), add(b0, b1));
+    sub_from(z1, z0);
+    sub_from(z1, z2);
+
+    Limbs result(a.size() + b.size() + 1, 0);
+    add_into(result, z0.data(), z0.size());
+    add_into(result, z1.data(), z1.size(), m);
+    add_into(result, z2.data(), z2.size(), 2 * m);
+    trim(result);
+    return result;
+}
+
+Limbs mul(const Limbs& a, const Limbs& b) {
+    if (a.empty() || b.empty()) {
+        return Limbs();
+    }
+    if (std::min(a.size(), b.size()) < kKaratsubaCutoff) {
+        Limbs result(a.size() + b.size());
+        mul_schoolbook(a.data(), a.size(), b.data(), b.size(), result.data());
+        trim(result);
+        return result;
+    }
+    return karatsuba(a, b);
+}
+
+int top_bit(unsigned long long n) {
+    int bit = 63;
+    while (bit > 0 && !((n >> bit) & 1)) {
+        --bit;
+    }
+    return bit;
+}
+
+} // namespace
+
+/**
+ * F(n) mod m by fast doubling; products use 128-bit intermediates.
+ */
+unsigned long long fibonacci_mod(unsigned long long n, unsigned long long mod) {
+    if (mod == 0) {
+        throw std::invalid_argument("mod must be positive");
+    }
+    if (n <= static_cast<unsigned long long>(small::kFibonacciMax)) {
+        return static_cast<unsigned long long>(small::kFibonacci[n]) % mod;
+    }
+    std::uint64_t a = 0;      // F(k)
+    std::uint64_t b = 1 % mod; // F(k + 1)
+    for (int bit = top_bit(n); bit >= 0; --bit) {
+        // 2 F(k+1) - F(k), kept in [0, mod)
+        std::uint64_t twice_b = (b >= mod - b) ? b - (mod - b) : b + b;
+        std::uint64_t t = (twice_b >= a) ? twice_b - a : twice_b + (mod - a);
+        std::uint64_t c = mul_mod(a, t, mod);                     // F(2k)
+        std::uint64_t a2 = mul_mod(a, a, mod);
+        std::uint64_t b2 = mul_mod(b, b, mod);
+        std::uint64_t d = (a2 >= mod - b2) ? a2 - (mod - b2) : a2 + b2;  // F(2k+1)
+        if ((n >> bit) & 1) {
+            a = d;
+            b = (c >= mod - d) ? c - (mod - d) : c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+/**
+ * F(n) mod 2^64 by fast doubling: unsigned arithmetic wraps for free.
+ */
+unsigned long long fibonacci_wrapped(unsigned long long n) {
+    if (n <= static_cast<unsigned long long>(small::kFibonacciMax)) {
+        return static_cast<unsigned long long>(small::kFibonacci[n]);
+    }
+    std::uint64_t a = 0;  // F(k)
+    std::uint64_t b = 1;  // F(k + 1)
+    for (int bit = top_bit(n); bit >= 0; --bit) {
+        const std::uint64_t c = a * (2 * b - a);  // F(2k)
+        const std::uint64_t d = a * a + b * b;    // F(2k+1)
+        if ((n >> bit) & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+/**
+ * Exact F(n) by fast doubling, as little-endian base 2^32 limbs.
+ */
+std::vector<std::uint32_t> fibonacci_big(unsigned long long n) {
+    if (n <= static_cast<unsigned long long>(small::kFibonacciMax)) {
+        const std::uint64_t value = static_cast<std::uint64_t>(small::kFibonacci[n]);
+        Limbs limbs = {static_cast<std::uint32_t>(value), static_cast<std::uint32_t>(value >> 32)};
+        trim(limbs);
+        return limbs;
+    }
+    Limbs a;        // F(k) = 0
+    Limbs b(1, 1);  // F(k + 1) = 1
+    for (int bit = top_bit(n); bit >= 0; --bit) {
+        Limbs t = add(b, b);
+        sub_from(t, a);
+        Limbs c = mul(a, t);                   // F(2k)
+        Limbs d = add(mul(a, a), mul(b, b));   // F(2k + 1)
+        if ((n >> bit) & 1) {
+            b = add(c, d);
+            a = std::move(d);
+        } else {
+            a = std::move(c);
+            b = std::move(d);
+        }
+    }
+    return a;
+}
+
+} // namespace cpp_functions
@@ -0,0 +1,726 @@
+#include "gemm.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cancellation.h"
+#include "cpu_features.h"
+#include "scratch.h"
+#include "thread_pool.h"
+
+// Intrinsics of every x86 extension are declared regardless of -m flags;
+// they may only be called from functions carrying a matching target
+#if defined(CPP_FUNCTIONS_X86)
+#include <immintrin.h>
+#elif defined(CPP_FUNCTIONS_AARCH64)
+#include <arm_neon.h>
+#endif
+
+/**
+ * General matrix multiply.
+ * Large products use the classic blocked scheme: B is packed into an
+ * L3-sized block of KC x NR panels, A into an L2-sized block of MR x KC
+ * panels, and an MR x NR register-blocked micro-kernel streams both panels
+ * from L1. Packing reads the operands through their strides, so the
+ * micro-kernel always sees contiguous data. With several threads the
+ * output is split into slabs of whole micro-tiles, one per thread of the
+ * shared pool, each packed and multiplied independently.
+ * The micro-kernel, its tile shape and the block sizes derived from it are
+ * chosen per element type on first use from simd_path().
+ */
+
+namespace cpp_functions {
+
+namespace {
+
+constexpr std::size_t kL1Bytes = 32 * 1024;
+constexpr std::size_t kL2Bytes = 256 * 1024;
+constexpr std::size_t kL3Bytes = 8 * 1024 * 1024;
+
+/** Products with fewer multiply-adds than this skip packing entirely. */
+constexpr std::size_t kBlockedMinWork = 32 * 32 * 32;
+
+/** Smallest product (multiply-adds) worth handing to each extra thread. */
+constexpr std::size_t kParallelMinWork = 128 * 128 * 128;
+
+/** Largest micro-tile of any kernel (AVX-512 float: 8 x 32). */
+constexpr std::size_t kMaxTileElements = 8 * 32;
+
+/**
+ * Integer products accumulate in the unsigned type of the same width so
+ * overflow wraps exactly like the reference i-k-j loop instead of being UB.
+ */
+template <typename T, bool = std::is_integral<T>::value>
+struct Accumulator {
+    using type = T;
+};
+
+template <typename T>
+struct Accumulator<T, true> {
+    using type = typename std::make_unsigned<T>::type;
+};
+
+template <typename T>
+using acc_t = typename Accumulator<T>::type;
+
+template <typename T>
+T wrap_add(T x, T y) {
+    return static_cast<T>(static_cast<acc_t<T>>(x) + static_cast<acc_t<T>>(y));
+}
+
+template <typename T>
+T wrap_sub(T x, T y) {
+    return static_cast<T>(static_cast<acc_t<T>>(x) - static_cast<acc_t<T>>(y));
+}
+
+template <typename T>
+T wrap_mul(T x, T y) {
+    return static_cast<T>(static_cast<acc_t<T>>(x) * static_cast<acc_t<T>>(y));
+}
+
+// ---------------------------------------------------------------------------
+// SIMD register operations. Each specialization wraps one vector ISA for one
+// floating point type; sizes are in elements. x86 operations carry their
+// target attribute so they inline into the kernels compiled for it.
+// ---------------------------------------------------------------------------
+
+#if defined(CPP_FUNCTIONS_X86)
+
+template <typename T>
+struct Avx512Ops;
+
+template <>
+struct Avx512Ops<double> {
+    using value_type = double;
+    using reg = __m512d;
+    static constexpr int width = 8;
+    CPP_FUNCTIONS_TARGET_AVX512 static reg zero() { return _mm512_setzero_pd(); }
+    CPP_FUNCTIONS_TARGET_AVX512 static reg load(const double* p) { return _mm512_loadu_pd(p); }
+    CPP_FUNCTIONS_TARGET_AVX512 static reg broadcast(double x) { return _mm512_set1_pd(x); }
+    CPP_FUNCTIONS_TARGET_AVX512 static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+    CPP_FUNCTIONS_TARGET_AVX512 static void store(double* p, reg v) { _mm512_storeu_pd(p, v); }
+};
+
+template <>
+struct Avx512Ops<float> {
+    using value_type = float;
+    using reg = __m512;
+    static constexpr int width = 16;
+    CPP_FUNCTIONS_TARGET_AVX512 static reg zero() { return _mm512_setzero_ps(); }
+    CPP_FUNCTIONS_TARGET_AVX512 static reg load(const float* p) { return _mm512_loadu_ps(p); }
+    CPP_FUNCTIONS_TARGET_AVX512 static reg broadcast(float x) { return _mm512_set1_ps(x); }
+    CPP_FUNCTIONS_TARGET_AVX512 static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+    CPP_FUNCTIONS_TARGET_AVX512 static void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+};
+
+template <typename T>
+struct Avx2Ops;
+
+template <>
+struct Avx2Ops<double> {
+    using value_type = double;
+    using reg = __m256d;
+    static constexpr int width = 4;
+    CPP_FUNCTIONS_TARGET_AVX2 static reg zero() { return _mm256_setzero_pd(); }
+    CPP_FUNCTIONS_TARGET_AVX2 static reg load(const double* p) { return _mm256_loadu_pd(p); }
+    CPP_FUNCTIONS_TARGET_AVX2 static reg broadcast(double x) { return _mm256_set1_pd(x); }
+    CPP_FUNCTIONS_TARGET_AVX2 static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+    CPP_FUNCTIONS_TARGET_AVX2 static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+};
+
+template <>
+struct Avx2Ops<float> {
+    using value_type = float;
+    using reg = __m256;
+    static constexpr int width = 8;
+    CPP_FUNCTIONS_TARGET_AVX2 static reg zero() { return _mm256_setzero_ps(); }
+    CPP_FUNCTIONS_TARGET_AVX2 static reg load(const float* p) { return _mm256_loadu_ps(p); }
+    CPP_FUNCTIONS_TARGET_AVX2 static reg broadcast(float x) { return _mm256_set1_ps(x); }
+    CPP_FUNCTIONS_TARGET_AVX2 static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+    CPP_FUNCTIONS_TARGET_AVX2 static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+};
+
+#elif defined(CPP_FUNCTIONS_AARCH64)
+
+template <typename T>
+struct NeonOps;
+
+template <>
+struct NeonOps<double> {
+    using value_type = double;
+    using reg = float64x2_t;
+    static constexpr int width = 2;
+    static reg zero() { return vdupq_n_f64(0.0); }
+    static reg load(const double* p) { return vld1q_f64(p); }
+    static reg broadcast(double x) { return vdupq_n_f64(x); }
+    static reg fma(reg a, reg b, reg c) { return vfmaq_f64(c, a, b); }
+    static void store(double* p, reg v) { vst1q_f64(p, v); }
+};
+
+template <>
+struct NeonOps<float> {
+    using value_type = float;
+    using reg = float32x4_t;
+    static constexpr int width = 4;
+    static reg zero() { return vdupq_n_f32(0.0f); }
+    static reg load(const float* p) { return vld1q_f32(p); }
+    static reg broadcast(float x) { return vdupq_n_f32(x); }
+    static reg fma(reg a, reg b, reg c) { return vfmaq_f32(c, a, b); }
+    static void store(float* p, reg v) { vst1q_f32(p, v); }
+};
+
+#endif
+
+// ---------------------------------------------------------------------------
+// Micro-kernels, one copy per target (see gemm_kernels.inc).
+// ---------------------------------------------------------------------------
+
+template <typename T>
+using MicroKernel = void (*)(std::size_t kc, const T* a, const T* b, T* tile);
+
+template <typename T>
+using SquareKernel = void (*)(const MatrixView<const T>& a, const MatrixView<const T>& b,
+                              const MatrixView<T>& c);
+
+/** Fixed-size kernels for the square products 2, 4, 8 and 16. */
+template <typename T>
+struct SquareKernels {
+    SquareKernel<T> by_log2[4];
+};
+
+namespace generic {
+#define CPP_GEMM_TARGET
+#include "gemm_kernels.inc"
+#undef CPP_GEMM_TARGET
+} // namespace generic
+
+#if defined(CPP_FUNCTIONS_X86)
+
+namespace sse42 {
+#define CPP_GEMM_TARGET CPP_FUNCTIONS_TARGET_SSE42
+#include "gemm_kernels.inc"
+#undef CPP_GEMM_TARGET
+} // namespace sse42
+
+namespace avx2 {
+#define CPP_GEMM_TARGET CPP_FUNCTIONS_TARGET_AVX2
+#include "gemm_kernels.inc"
+#undef CPP_GEMM_TARGET
+} // namespace avx2
+
+namespace avx512 {
+#define CPP_GEMM_TARGET CPP_FUNCTIONS_TARGET_AVX512
+#include "gemm_kernels.inc"
+#undef CPP_GEMM_TARGET
+} // namespace avx512
+
+#endif
+
+/**
+ * A micro-kernel with its tile shape and cache blocking: a KC x NR panel
+ * of B and an MR x KC panel of A share L1, an MC x KC block of A stays in
+ * L2 and a KC x NC block of B in L3.
+ */
+template <typename T>
+struct GemmKernel {
+    const char* name;
+    std::size_t mr, nr;
+    std::size_t kc, mc, nc;
+    MicroKernel<T> micro;
+    SquareKernels<T> square;
+};
+
+template <typename T, int MR, int NR>
+GemmKernel<T> make_kernel(const char* name, MicroKernel<T> micro, SquareKernels<T> square) {
+    static_assert(MR * NR <= static_cast<int>(kMaxTileElements), "micro-tile too large");
+    GemmKernel<T> kernel;
+    kernel.name = name;
+    kernel.mr = MR;
+    kernel.nr = NR;
+    kernel.kc = kL1Bytes / 2 / (NR * sizeof(T));
+    kernel.mc = (kL2Bytes / 2 / (kernel.kc * sizeof(T))) / MR * MR;
+    kernel.nc = (kL3Bytes / 2 / (kernel.kc * sizeof(T))) / NR * NR;
+    kernel.micro = micro;
+    kernel.square = square;
+    return kernel;
+}
+
+/**
+ * Integers have no FMA kernel: the portable 4 x 8 tile, compiled for the
+ * widest target so the compiler can vectorize it with that ISA.
+ */
+template <typename T>
+GemmKernel<T> select_kernel(SimdPath path, std::false_type) {
+    switch (path) {
+#if defined(CPP_FUNCTIONS_X86)
+    case SimdPath::avx512:
+        return make_kernel<T, 4, 8>("avx512", &avx512::scalar_micro_kernel<T, 4, 8>,
+                                    avx512::square_kernels<T>());
+    case SimdPath::avx2:
+        return make_kernel<T, 4, 8>("avx2", &avx2::scalar_micro_kernel<T, 4, 8>,
+                                    avx2::square_kernels<T>());
+    case SimdPath::sse42:
+        return make_kernel<T, 4, 8>("sse42", &sse42::scalar_micro_kernel<T, 4, 8>,
+                                    sse42::square_kernels<T>());
+#endif
+    default:
+        return make_kernel<T, 4, 8>("generic", &generic::scalar_micro_kernel<T, 4, 8>,
+                                    generic::square_kernels<T>());
+    }
+}
+
+/**
+ * Floating point SIMD kernels use two vectors per row and as many rows as
+ * leave registers for the B loads: 8 with 32 vector registers (AVX-512,
+ * AArch64), 6 with 16 (AVX2).
+ */
+template <typename T>
+GemmKernel<T> select_kernel(SimdPath path, std::true_type) {
+    switch (path) {
+#if defined(CPP_FUNCTIONS_X86)
+    case SimdPath::avx512: {
+        constexpr int nr = 2 * Avx512Ops<T>::width;
+        return make_kernel<T, 8, nr>("avx512", &avx512::simd_micro_kernel<Avx512Ops<T>, 8, nr>,
+                                     avx512::square_kernels<T>());
+    }
+    case SimdPath::avx2: {
+        constexpr int nr = 2 * Avx2Ops<T>::width;
+        return make_kernel<T, 6, nr>("avx2", &avx2::simd_micro_kernel<Avx2Ops<T>, 6, nr>,
+                                     avx2::square_kernels<T>());
+    }
+    case SimdPath::sse42:
+        return make_kernel<T, 4, 8>("sse42", &sse42::scalar_micro_kernel<T, 4, 8>,
+                                    sse42::square_kernels<T>());
+#elif defined(CPP_FUNCTIONS_AARCH64)
+    case SimdPath::neon: {
+        constexpr int nr = 2 * NeonOps<T>::width;
+        return make_kernel<T, 8, nr>("neon", &generic::simd_micro_kernel<NeonOps<T>, 8, nr>,
+                                     generic::square_kernels<T>());
+    }
+#endif
+    default:
+        return make_kernel<T, 4, 8>("generic", &generic::scalar_micro_kernel<T, 4, 8>,
+                                    generic::square_kernels<T>());
+    }
+}
+
+template <typename T>
+const GemmKernel<T>& active_kernel() {
+    static const GemmKernel<T> kernel = select_kernel<T>(simd_path(), std::is_floating_point<T>());
+    return kernel;
+}
+
+/** Dispatch a square 2, 4, 8 or 16 product to its fixed-size kernel; false otherwise. */
+template <typename T>
+bool gemm_small_square(const MatrixView<const T>& a, const MatrixView<const T>& b,
+                       const MatrixView<T>& c, const GemmKernel<T>& kernel) {
+    if (a.rows != a.cols || b.cols != a.cols) {
+        return false;
+    }
+    switch (a.rows) {
+    case 2:
+        kernel.square.by_log2[0](a, b, c);
+        return true;
+    case 4:
+        kernel.square.by_log2[1](a, b, c);
+        return true;
+    case 8:
+        kernel.square.by_log2[2](a, b, c);
+        return true;
+    case 16:
+        kernel.square.by_log2[3](a, b, c);
+        return true;
+    default:
+        return false;
+    }
+}
+
+/** Pack rows [i0, i0 + mc) x cols [p0, p0 + kc) of a into mr-row panels. */
+template <typename T>
+void pack_a(const MatrixView<const T>& a, std::size_t mr, std::size_t i0, std::size_t mc,
+            std::size_t p0, std::size_t kc, T* out) {
+    for (std::size_t ir = 0; ir < mc; ir += mr) {
+        const std::size_t rows = std::min(mr, mc - ir);
+        for (std::size_t k = 0; k < kc; ++k) {
+            for (std::size_t i = 0; i < rows; ++i) {
+                out[i] = a(i0 + ir + i, p0 + k);
+            }
+            for (std::size_t i = rows; i < mr; ++i) {
+                out[i] = T(0);
+            }
+            out += mr;
+        }
+    }
+}
+
+/** Pack rows [p0, p0 + kc) x cols [j0, j0 + nc) of b into nr-column panels. */
+template <typename T>
+void pack_b(const MatrixView<const T>& b, std::size_t nr, std::size_t p0, std::size_t kc,
+            std::size_t j0, std::size_t nc, T* out) {
+    for (std::size_t jr = 0; jr < nc; jr += nr) {
+        const std::size_t cols = std::min(nr, nc - jr);
+        for (std::size_t k = 0; k < kc; ++k) {
+            if (cols == nr && b.col_stride == 1) {
+                const T* src = &b(p0 + k, j0 + jr);
+                std::copy(src, src + nr, out);
+            } else {
+                for (std::size_t j = 0; j < cols; ++j) {
+                    out[j] = b(p0 + k, j0 + jr + j);
+                }
+                for (std::size_t j = cols; j < nr; ++j) {
+                    out[j] = T(0);
+                }
+            }
+            out += nr;
+        }
+    }
+}
+
+template <typename T>
+void gemm_blocked(const MatrixView<const T>& a, const MatrixView<const T>& b,
+                  const MatrixView<T>& c, const GemmKernel<T>& kernel) {
+    const std::size_t mr = kernel.mr;
+    const std::size_t nr = kernel.nr;
+    const std::size_t m = a.rows;
+    const std::size_t k_dim = a.cols;
+    const std::size_t n = b.cols;
+
+    auto round_up = [](std::size_t x, std::size_t step) { return (x + step - 1) / step * step; };
+    const std::size_t kc_max = std::min(kernel.kc, k_dim);
+    scratch::Array<T> packed_a(round_up(std::min(kernel.mc, m), mr) * kc_max);
+    scratch::Array<T> packed_b(round_up(std::min(kernel.nc, n), nr) * kc_max);
+    alignas(kMatrixAlignment) T tile[kMaxTileElements];
+
+    for (std::size_t jc = 0; jc < n; jc += kernel.nc) {
+        const std::size_t nc = std::min(kernel.nc, n - jc);
+        for (std::size_t pc = 0; pc < k_dim; pc += kernel.kc) {
+            const std::size_t kc = std::min(kernel.kc, k_dim - pc);
+            const bool first = pc == 0;
+            pack_b(b, nr, pc, kc, jc, nc, packed_b.data());
+
+            for (std::size_t ic = 0; ic < m; ic += kernel.mc) {
+                const std::size_t mc = std::min(kernel.mc, m - ic);
+                // One check per mc x kc x nc block keeps the cost negligible
+                cancellation_point();
+                pack_a(a, mr, ic, mc, pc, kc, packed_a.data());
+
+                for (std::size_t jr = 0; jr < nc; jr += nr) {
+                    const std::size_t cols = std::min(nr, nc - jr);
+                    const T* b_panel = packed_b.data() + jr * kc;
+                    for (std::size_t ir = 0; ir < mc; ir += mr) {
+                        const std::size_t rows = std::min(mr, mc - ir);
+                        kernel.micro(kc, packed_a.data() + ir * kc, b_panel, tile);
+
+                        for (std::size_t i = 0; i < rows; ++i) {
+                            for (std::size_t j = 0; j < cols; ++j) {
+                                T& dest = c(ic + ir + i, jc + jr + j);
+                                const T value = tile[i * nr + j];
+                                dest = first ? value : wrap_add(dest, value);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Split c into slabs along its longer side and run the blocked kernel on
+ * each slab on the shared pool. Every slab packs its own panels, which
+ * costs one extra pass over the shared operand per slab but needs no
+ * synchronisation beyond the final join.
+ */
+template <typename T>
+void gemm_parallel(const MatrixView<const T>& a, const MatrixView<const T>& b,
+                   const MatrixView<T>& c, unsigned threads, const GemmKernel<T>& kernel) {
+    const bool split_rows = c.rows >= c.cols;
+    const std::size_t extent = split_rows ? c.rows : c.cols;
+    const std::size_t step = split_rows ? kernel.mr : kernel.nr;
+
+    // Whole micro-tiles per slab, rounded so the last slab is not tiny
+    std::size_t slab = (extent + threads - 1) / threads;
+    slab = (slab + step - 1) / step * step;
+    const std::size_t slabs = (extent + slab - 1) / slab;
+
+    parallel_for(slabs, threads, [&](std::size_t id) {
+        const std::size_t first = id * slab;
+        const std::size_t length = std::min(slab, extent - first);
+        if (split_rows) {
+            gemm_blocked(a.block(first, 0, length, a.cols), b,
+                         c.block(first, 0, length, c.cols), kernel);
+        } else {
+            gemm_blocked(a, b.block(0, first, b.rows, length),
+                         c.block(0, first, c.rows, length), kernel);
+        }
+    });
+}
+
+
+} // namespace
+
+template <typename T>
+void gemm_reference(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c) {
+    if (a.cols != b.rows || c.rows != a.rows || c.cols != b.cols) {
+        throw std::invalid_argument("gemm: shapes do not align");
+    }
+    const std::size_t m = a.rows;
+    const std::size_t k_dim = a.cols;
+    const std::size_t n = b.cols;
+
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            c(i, j) = T(0);
+        }
+        for (std::size_t k = 0; k < k_dim; ++k) {
+            const T a_ik = a(i, k);
+            for (std::size_t j = 0; j < n; ++j) {
+                c(i, j) = wrap_add(c(i, j), wrap_mul(a_ik, b(k, j)));
+            }
+        }
+    }
+}
+
+template <typename T>
+void gemm(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c, unsigned threads) {
+    if (a.cols != b.rows || c.rows != a.rows || c.cols != b.cols) {
+        throw std::invalid_argument("gemm: shapes do not align");
+    }
+    if (a.cols == 0) {
+        for (std::size_t i = 0; i < c.rows; ++i) {
+            for (std::size_t j = 0; j < c.cols; ++j) {
+                c(i, j) = T(0);
+            }
+        }
+        return;
+    }
+    const std::size_t work = a.rows * a.cols * b.cols;
+    if (work < kBlockedMinWork) {
+        if (!gemm_small_square(a, b, c, active_kernel<T>())) {
+            gemm_reference(a, b, c);
+        }
+        return;
+    }
+    threads = static_cast<unsigned>(std::min<std::size_t>(resolve_threads(threads),
+                                                          work / kParallelMinWork));
+    const GemmKernel<T>& kernel = active_kernel<T>();
+    if (threads <= 1) {
+        gemm_blocked(a, b, c, kernel);
+        return;
+    }
+    gemm_parallel(a, b, c, threads, kernel);
+}
+
+template <typename T>
+const char* gemm_kernel_name() {
+    return active_kernel<T>().name;
+}
+
+namespace {
+
+/**
+ * Scratch for Strassen-Winograd: three quadrant-sized temporaries per
+ * recursion level, carved out of one scratch lease up front. Sibling calls at
+ * the same depth run one after another, so each level reuses its region.
+ */
+template <typename T>
+class StrassenWorkspace {
+public:
+    StrassenWorkspace(std::size_t m, std::size_t k, std::size_t n, int levels)
+        : offsets_(levels + 1, 0), m_(m), k_(k), n_(n) {
+        for (int d = 0; d < levels; ++d) {
+            const std::size_t mh = m >> (d + 1), kh = k >> (d + 1), nh = n >> (d + 1);
+            offsets_[d + 1] = offsets_[d] + mh * kh + kh * nh + mh * nh;
+        }
+        buffer_ = scratch::Array<T>(offsets_.back());
+    }
+
+    /** Temporaries shaped like an A, B and C quadrant at depth d. */
+    MatrixView<T> a_temp(int d) { return temp(d, 0, m_ >> (d + 1), k_ >> (d + 1)); }
+    MatrixView<T> b_temp(int d) {
+        return temp(d, (m_ >> (d + 1)) * (k_ >> (d + 1)), k_ >> (d + 1), n_ >> (d + 1));
+    }
+    MatrixView<T> c_temp(int d) {
+        const std::size_t kh = k_ >> (d + 1);
+        return temp(d, (m_ >> (d + 1)) * kh + kh * (n_ >> (d + 1)), m_ >> (d + 1), n_ >> (d + 1));
+    }
+
+private:
+    MatrixView<T> temp(int d, std::size_t offset, std::size_t rows, std::size_t cols) {
+        return MatrixView<T>{buffer_.data() + offsets_[d] + offset, rows, cols,
+                             static_cast<std::ptrdiff_t>(cols), 1};
+    }
+
+    scratch::Array<T> buffer_;
+    std::vector<std::size_t> offsets_;
+    std::size_t m_, k_, n_;
+};
+
+template <typename T>
+MatrixView<const T> as_const(const MatrixView<T>& v) {
+    return MatrixView<const T>{v.data, v.rows, v.cols, v.row_stride, v.col_stride};
+}
+
+/** out = x + y, or x - y when subtract is set. out may alias x or y. */
+template <typename T>
+void combine(const MatrixView<T>& out, const MatrixView<const T>& x,
+             const MatrixView<const T>& y, bool subtract) {
+    if (out.col_stride == 1 && x.col_stride == 1 && y.col_stride == 1) {
+        // Unit-stride rows: let the compiler vectorize the inner loop
+        for (std::size_t i = 0; i < out.rows; ++i) {
+            T* o = &out(i, 0);
+            const T* xr = &x(i, 0);
+            const T* yr = &y(i, 0);
+            if (subtract) {
+                for (std::size_t j = 0; j < out.cols; ++j) {
+                    o[j] = wrap_sub(xr[j], yr[j]);
+                }
+            } else {
+                for (std::size_t j = 0; j < out.cols; ++j) {
+                    o[j] = wrap_add(xr[j], yr[j]);
+                }
+            }
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < out.rows; ++i) {
+        for (std::size_t j = 0; j < out.cols; ++j) {
+            out(i, j) = subtract ? wrap_sub(x(i, j), y(i, j)) : wrap_add(x(i, j), y(i, j));
+        }
+    }
+}
+
+/** out = w + x + y, the one three-term update in the schedule. */
+template <typename T>
+void combine3(const MatrixView<T>& out, const MatrixView<const T>& w,
+              const MatrixView<const T>& x, const MatrixView<const T>& y) {
+    for (std::size_t i = 0; i < out.rows; ++i) {
+        for (std::size_t j = 0; j < out.cols; ++j) {
+            out(i, j) = wrap_add(wrap_add(w(i, j), x(i, j)), y(i, j));
+        }
+    }
+}
+
+/**
+ * One level of Winograd's variant: 7 half-size products and 15 additions.
+ * Dimensions are multiples of 2^(levels - depth). Products are written
+ * straight into quadrants of c where possible, so each level needs only
+ * the three workspace temporaries X, Y and Z.
+ */
+template <typename T>
+void strassen_level(const MatrixView<const T>& a, const MatrixView<const T>& b,
+                    const MatrixView<T>& c, int depth, int levels,
+                    StrassenWorkspace<T>& ws, unsigned threads) {
+    if (depth == levels) {
+        gemm(a, b, c, threads);
+        return;
+    }
+    const std::size_t mh = a.rows / 2, kh = a.cols / 2, nh = b.cols / 2;
+    const auto a11 = a.block(0, 0, mh, kh), a12 = a.block(0, kh, mh, kh);
+    const auto a21 = a.block(mh, 0, mh, kh), a22 = a.block(mh, kh, mh, kh);
+    const auto b11 = b.block(0, 0, kh, nh), b12 = b.block(0, nh, kh, nh);
+    const auto b21 = b.block(kh, 0, kh, nh), b22 = b.block(kh, nh, kh, nh);
+    const auto c11 = c.block(0, 0, mh, nh), c12 = c.block(0, nh, mh, nh);
+    const auto c21 = c.block(mh, 0, mh, nh), c22 = c.block(mh, nh, mh, nh);
+    const MatrixView<T> x = ws.a_temp(depth), y = ws.b_temp(depth), z = ws.c_temp(depth);
+    auto recurse = [&](const MatrixView<const T>& lhs, const MatrixView<const T>& rhs,
+                       const MatrixView<T>& out) {
+        strassen_level(lhs, rhs, out, depth + 1, levels, ws, threads);
+    };
+
+    recurse(a11, b11, c11);                                       // P1
+    combine(x, a21, a22, false);                                  // S1 = A21 + A22
+    combine(y, b12, b11, true);                                   // T1 = B12 - B11
+    recurse(as_const(x), as_const(y), c22);                       // P5 = S1 T1
+    combine(x, as_const(x), a11, true);                           // S2 = S1 - A11
+    combine(y, b22, as_const(y), true);                           // T2 = B22 - T1
+    recurse(as_const(x), as_const(y), c21);                       // P6 = S2 T2
+    combine(c21, as_const(c21), as_const(c11), false);            // U2 = P1 + P6
+    combine(x, a12, as_const(x), true);                           // S4 = A12 - S2
+    recurse(as_const(x), b22, c12);                               // P3 = S4 B22
+    combine3(c12, as_const(c12), as_const(c21), as_const(c22));   // U5 = P3 + U2 + P5
+    combine(x, a11, a21, true);                                   // S3 = A11 - A21
+    combine(y, b22, b12, true);                                   // T3 = B22 - B12
+    recurse(as_const(x), as_const(y), z);                         // P7 = S3 T3
+    combine(c21, as_const(c21), as_const(z), false);              // U3 = U2 + P7
+    combine(c22, as_const(c22), as_const(c21), false);            // U7 = U3 + P5
+    combine(y, as_const(y), b11, false);                          // T2 = T3 + B11
+    combine(y, as_const(y), b21, true);                           // T4 = T2 - B21
+    recurse(a22, as_const(y), z);                                 // P4 = A22 T4
+    combine(c21, as_const(c21), as_const(z), true);               // U6 = U3 - P4
+    recurse(a12, b21, z);                                         // P2
+    combine(c11, as_const(c11), as_const(z), false);              // U1 = P1 + P2
+}
+
+} // namespace
+
+template <typename T>
+void gemm_strassen(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c,
+                   std::size_t cutoff, unsigned threads) {
+    if (a.cols != b.rows || c.rows != a.rows || c.cols != b.cols) {
+        throw std::invalid_argument("gemm: shapes do not align");
+    }
+    if (cutoff == 0) {
+        throw std::invalid_argument("gemm_strassen: cutoff must be positive");
+    }
+    // Halve while every dimension stays at or above the cutoff
+    int levels = 0;
+    while (std::min({a.rows, a.cols, b.cols}) >> (levels + 1) >= cutoff) {
+        ++levels;
+    }
+    if (levels == 0) {
+        gemm(a, b, c, threads);
+        return;
+    }
+
+    const std::size_t step = std::size_t(1) << levels;
+    auto round_up = [step](std::size_t x) { return (x + step - 1) / step * step; };
+    const std::size_t m = round_up(a.rows), k = round_up(a.cols), n = round_up(b.cols);
+    StrassenWorkspace<T> ws(m, k, n, levels);
+    if (m == a.rows && k == a.cols && n == b.cols) {
+        strassen_level(a, b, c, 0, levels, ws, threads);
+        return;
+    }
+
+    // Zero-pad to a multiple of 2^levels; the padding contributes nothing
+    scratch::Array<T> pad(m * k + k * n + m * n);
+    std::fill(pad.data(), pad.data() + m * k + k * n, T(0));
+    const MatrixView<T> a_pad{pad.data(), m, k, static_cast<std::ptrdiff_t>(k), 1};
+    const MatrixView<T> b_pad{pad.data() + m * k, k, n, static_cast<std::ptrdiff_t>(n), 1};
+    const MatrixView<T> c_pad{pad.data() + m * k + k * n, m, n, static_cast<std::ptrdiff_t>(n), 1};
+    for (std::size_t i = 0; i < a.rows; ++i) {
+        for (std::size_t j = 0; j < a.cols; ++j) {
+            a_pad(i, j) = a(i, j);
+        }
+    }
+    for (std::size_t i = 0; i < b.rows; ++i) {
+        for (std::size_t j = 0; j < b.cols; ++j) {
+            b_pad(i, j) = b(i, j);
+        }
+    }
+    strassen_level(as_const(a_pad), as_const(b_pad), c_pad, 0, levels, ws, threads);
+    for (std::size_t i = 0; i < c.rows; ++i) {
+        for (std::size_t j = 0; j < c.cols; ++j) {
+            c(i, j) = c_pad(i, j);
+        }
+    }
+}
+
+#define CPP_FUNCTIONS_INSTANTIATE_GEMM(T)                                                     \
+    template void gemm<T>(MatrixView<const T>, MatrixView<const T>, MatrixView<T>, unsigned);      \
+    template void gemm_reference<T>(MatrixView<const T>, MatrixView<const T>, MatrixView<T>);  \
+    template const char* gemm_kernel_name<T>();                                                \
+    template void gemm_strassen<T>(MatrixView<const T>, MatrixView<const T>, MatrixView<T>,   \
+                                   std::size_t, unsigned);
+
+CPP_FUNCTIONS_INSTANTIATE_GEMM(std::int32_t)
+CPP_FUNCTIONS_INSTANTIATE_GEMM(std::int64_t)
+CPP_FUNCTIONS_INSTANTIATE_GEMM(float)
+CPP_FUNCTIONS_INSTANTIATE_GEMM(double)
+
+#undef CPP_FUNCTIONS_INSTANTIATE_GEMM
+
+} // namespace cpp_functions
@@ -0,0 +1,83 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <cstddef>
+#include <cstdint>
+#include "matrix.h"
+
+/**
+ * General matrix multiply over caller-supplied matrices.
+ * Operands are strided views, so transposed or sliced inputs are read in
+ * place without being copied first.
+ */
+
+namespace cpp_functions {
+
+/**
+ * c = a * b for an m x k matrix a and a k x n matrix b; c must be m x n
+ * and must not overlap a or b. Throws std::invalid_argument on a shape
+ * mismatch. Large products run the packed, cache-blocked kernel with a
+ * SIMD micro-kernel for float and double (AVX-512, AVX2+FMA or NEON,
+ * whichever the CPU supports at run time); square 2, 4, 8 and 16 products
+ * use kernels specialized for their size. Packing buffers are leased
+ * from the scratch arena of whichever thread runs the slab (scratch.h).
+ * Integer products wrap on overflow and are bit-identical to gemm_reference.
+ * threads > 1 splits c into slabs computed on the shared pool (0 = the
+ * whole pool); small products always run on the calling thread.
+ * Instantiated for int32_t, int64_t, float and double.
+ */
+template <typename T>
+void gemm(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c, unsigned threads = 1);
+
+/**
+ * Straightforward i-k-j multiply, used for small products and as the
+ * baseline the blocked kernel is checked against.
+ */
+template <typename T>
+void gemm_reference(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c);
+
+/**
+ * simd_path() name of the micro-kernel gemm<T> runs on this CPU; integer
+ * types get the portable tile compiled for that path.
+ */
+template <typename T>
+const char* gemm_kernel_name();
+
+/** Multiply algorithm selectable from Python via matmul(algorithm=...). */
+enum class GemmAlgorithm {
+    classical,  // blocked O(n^3) kernel
+    strassen,   // Strassen-Winograd recursion over the blocked kernel
+};
+
+/** Product size below which gemm_strassen stops recursing by default. */
+constexpr std::size_t kStrassenCutoff = 256;
+
+/**
+ * Strassen-Winograd multiply: 7 half-size products per level instead of 8.
+ * Recurses while every dimension is at least cutoff after halving and
+ * finishes each leaf with gemm; odd shapes are zero-padded to the recursion
+ * grid. Temporaries come from one scratch lease taken up front. Integer
+ * results match gemm exactly (the identities hold modulo 2^bits); float
+ * results carry somewhat larger rounding error than the classical kernel.
+ */
+template <typename T>
+void gemm_strassen(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c,
+                   std::size_t cutoff = kStrassenCutoff, unsigned threads = 1);
+
+#define CPP_FUNCTIONS_DECLARE_GEMM(T)                                                                \
+    extern template void gemm<T>(MatrixView<const T>, MatrixView<const T>, MatrixView<T>, unsigned);      \
+    extern template void gemm_reference<T>(MatrixView<const T>, MatrixView<const T>, MatrixView<T>);  \
+    extern template const char* gemm_kernel_name<T>();                                                \
+    extern template void gemm_strassen<T>(MatrixView<const T>, MatrixView<const T>, MatrixView<T>,   \
+                                          std::size_t, unsigned);
+
+CPP_FUNCTIONS_DECLARE_GEMM(std::int32_t)
+CPP_FUNCTIONS_DECLARE_GEMM(std::int64_t)
+CPP_FUNCTIONS_DECLARE_GEMM(float)
+CPP_FUNCTIONS_DECLARE_GEMM(double)
+
+#undef CPP_FUNCTIONS_DECLARE_GEMM
+
+} // namespace cpp_functions
+
+#endif // GEMM_H
@@ -0,0 +1,130 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+
+/**
+ * Dense row-major matrix stored in one aligned, contiguous buffer.
+ * Replaces vector<vector<T>> so a matrix is a single allocation that the
+ * kernels can stream through and that NumPy can adopt without copying.
+ */
+
+namespace cpp_functions {
+
+/** Buffer alignment in bytes: one cache line, enough for AVX-512 loads. */
+constexpr std::size_t kMatrixAlignment = 64;
+
+/**
+ * Allocate bytes aligned to kMatrixAlignment. Throws std::bad_alloc.
+ */
+inline void* aligned_allocate(std::size_t bytes) {
+    if (bytes == 0) {
+        bytes = kMatrixAlignment;
+    }
+    void* p = nullptr;
+#if defined(_WIN32)
+    p = _aligned_malloc(bytes, kMatrixAlignment);
+#else
+    if (posix_memalign(&p, kMatrixAlignment, bytes) != 0) {
+        p = nullptr;
+    }
+#endif
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+inline void aligned_deallocate(void* p) {
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+template <typename T>
+class Matrix {
+public:
+    Matrix() = default;
+
+    /**
+     * rows x cols matrix with every element set to zero.
+     */
+    Matrix(std::size_t rows, std::size_t cols)
+        : rows_(rows), cols_(cols),
+          data_(static_cast<T*>(aligned_allocate(rows * cols * sizeof(T)))) {
+        std::memset(data_.get(), 0, rows * cols * sizeof(T));
+    }
+
+    Matrix(Matrix&&) noexcept = default;
+    Matrix& operator=(Matrix&&) noexcept = default;
+    Matrix(const Matrix&) = delete;
+    Matrix& operator=(const Matrix&) = delete;
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    std::size_t size() const { return rows_ * cols_; }
+
+    T* data() { return data_.get(); }
+    const T* data() const { return data_.get(); }
+
+    T* row(std::size_t i) { return data_.get() + i * cols_; }
+    const T* row(std::size_t i) const { return data_.get() + i * cols_; }
+
+    T& operator()(std::size_t i, std::size_t j) { return data_.get()[i * cols_ + j]; }
+    const T& operator()(std::size_t i, std::size_t j) const { return data_.get()[i * cols_ + j]; }
+
+private:
+    struct Deleter {
+        void operator()(T* p) const { aligned_deallocate(p); }
+    };
+
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::unique_ptr<T, Deleter> data_;
+};
+
+/**
+ * Non-owning view of a matrix with arbitrary element strides, e.g. a
+ * transposed or sliced NumPy array. T may be const for read-only inputs.
+ */
+template <typename T>
+struct MatrixView {
+    T* data = nullptr;
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::ptrdiff_t row_stride = 0;  // in elements
+    std::ptrdiff_t col_stride = 1;  // in elements
+
+    T& operator()(std::size_t i, std::size_t j) const {
+        return data[static_cast<std::ptrdiff_t>(i) * row_stride +
+                    static_cast<std::ptrdiff_t>(j) * col_stride];
+    }
+
+    /** The rows x cols sub-matrix whose top-left element is (i, j). */
+    MatrixView block(std::size_t i, std::size_t j, std::size_t block_rows, std::size_t block_cols) const {
+        return MatrixView{&(*this)(i, j), block_rows, block_cols, row_stride, col_stride};
+    }
+
+    /** True when rows are contiguous, as in a freshly allocated Matrix. */
+    bool row_major() const { return col_stride == 1 && row_stride == static_cast<std::ptrdiff_t>(cols); }
+};
+
+template <typename T>
+MatrixView<T> view(Matrix<T>& m) {
+    return MatrixView<T>{m.data(), m.rows(), m.cols(), static_cast<std::ptrdiff_t>(m.cols()), 1};
+}
+
+template <typename T>
+MatrixView<const T> view(const Matrix<T>& m) {
+    return MatrixView<const T>{m.data(), m.rows(), m.cols(), static_cast<std::ptrdiff_t>(m.cols()), 1};
+}
+
+} // namespace cpp_functions
+
+#endif // MATRIX_H
@@ -0,0 +1,339 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+/**
+ * Sharded call counters. Each thread owns a Shard whose per-function Slots
+ * are allocated the first time that thread calls the function. Only the
+ * owner writes a slot, which it does with relaxed load + store pairs, so
+ * the fast path never contends; readers take the registry mutex, which
+ * also keeps shards from being retired while they are summed.
+ */
+
+namespace cpp_functions {
+namespace metrics {
+
+namespace {
+
+constexpr unsigned kSubBucketBits = 3;
+constexpr std::uint64_t kSubBuckets = 1u << kSubBucketBits;
+constexpr unsigned kMaxExponent = 42;
+
+struct Slot {
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> errors{0};
+    std::atomic<std::uint64_t> total_ns{0};
+    std::atomic<std::uint64_t> buckets[kBucketCount];
+
+    Slot() {
+        for (std::atomic<std::uint64_t>& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+/** Single-writer increment; only the owning thread may call it. */
+inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+struct Shard {
+    std::atomic<Slot*> slots[kMaxFunctions];
+
+    Shard() {
+        for (std::atomic<Slot*>& slot : slots) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    ~Shard() {
+        for (std::atomic<Slot*>& slot : slots) {
+            delete slot.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+/** Plain totals, used for retired shards and the reset() baseline. */
+struct Totals {
+    std::uint64_t calls = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t total_ns = 0;
+    std::vector<std::uint64_t> buckets = std::vector<std::uint64_t>(kBucketCount, 0);
+
+    void add(const Slot& slot) {
+        calls += slot.calls.load(std::memory_order_relaxed);
+        errors += slot.errors.load(std::memory_order_relaxed);
+        total_ns += slot.total_ns.load(std::memory_order_relaxed);
+        for (std::size_t b = 0; b < kBucketCount; ++b) {
+            buckets[b] += slot.buckets[b].load(std::memory_order_relaxed);
+        }
+    }
+
+    void add(const Totals& other) {
+        calls += other.calls;
+        errors += other.errors;
+        total_ns += other.total_ns;
+        for (std::size_t b = 0; b < kBucketCount; ++b) {
+            buckets[b] += other.buckets[b];
+        }
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<Shard*> shards;
+    std::vector<Totals> retired;   // from threads that have exited
+    std::vector<Totals> baseline;  // totals at the last reset()
+};
+
+/** Leaked so threads exiting during static destruction can still retire. */
+Registry& registry() {
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+/**
+ * Registers the calling thread's shard and, at thread exit, folds its
+ * counts into the retired totals.
+ */
+class ShardOwner {
+public:
+    ShardOwner() : shard_(new Shard) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.shards.push_back(shard_.get());
+    }
+
+    ~ShardOwner() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (std::size_t id = 0; id < kMaxFunctions; ++id) {
+            if (const Slot* slot = shard_->slots[id].load(std::memory_order_acquire)) {
+                r.retired[id].add(*slot);
+            }
+        }
+        for (std::size_t i = 0; i < r.shards.size(); ++i) {
+            if (r.shards[i] == shard_.get()) {
+                r.shards.erase(r.shards.begin() + static_cast<std::ptrdiff_t>(i));
+                break;
+            }
+        }
+    }
+
+    Slot& slot(std::size_t id) {
+        Slot* slot = shard_->slots[id].load(std::memory_order_relaxed);
+        if (!slot) {
+            slot = new Slot;
+            shard_->slots[id].store(slot, std::memory_order_release);
+        }
+        return *slot;
+    }
+
+private:
+    std::unique_ptr<Shard> shard_;
+};
+
+ShardOwner& local_shard() {
+    thread_local ShardOwner owner;
+    return owner;
+}
+
+/** Current totals of function id; the registry mutex must be held. */
+Totals current_totals(Registry& r, std::size_t id) {
+    Totals totals = r.retired[id];
+    for (const Shard* shard : r.shards) {
+        if (const Slot* slot = shard->slots[id].load(std::memory_order_acquire)) {
+            totals.add(*slot);
+        }
+    }
+    return totals;
+}
+
+void format_label_value(std::string& out, const std::string& value) {
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+        }
+        out += c == '\n' ? 'n' : c;
+    }
+}
+
+void append_number(std::string& out, double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    out += buffer;
+}
+
+} // namespace
+
+std::size_t register_function(const std::string& name) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (std::size_t id = 0; id < r.names.size(); ++id) {
+        if (r.names[id] == name) {
+            return id;
+        }
+    }
+    if (r.names.size() == kMaxFunctions) {
+        throw std::length_error("metrics: too many registered functions");
+    }
+    r.names.push_back(name);
+    r.retired.emplace_back();
+    r.baseline.emplace_back();
+    return r.names.size() - 1;
+}
+
+std::size_t bucket_index(std::uint64_t nanoseconds) {
+    if (nanoseconds < kSubBuckets) {
+        return static_cast<std::size_t>(nanoseconds);
+    }
+    const unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(nanoseconds));
+    if (exponent > kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    // Top kSubBucketBits bits below the leading one pick the sub-bucket
+    const unsigned shift = exponent - kSubBucketBits;
+    return static_cast<std::size_t>((exponent - kSubBucketBits + 1) * kSubBuckets +
+                                    ((nanoseconds >> shift) & (kSubBuckets - 1)));
+}
+
+std::uint64_t bucket_upper_bound(std::size_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    const unsigned shift = static_cast<unsigned>(bucket / kSubBuckets) - 1;
+    const std::uint64_t lower = (kSubBuckets + bucket % kSubBuckets) << shift;
+    return lower + (std::uint64_t(1) << shift) - 1;
+}
+
+void record(std::size_t id, std::uint64_t nanoseconds, bool failed) {
+    if (id >= kMaxFunctions) {
+        return;
+    }
+    Slot& slot = local_shard().slot(id);
+    bump(slot.calls, 1);
+    if (failed) {
+        bump(slot.errors, 1);
+    }
+    bump(slot.total_ns, nanoseconds);
+    bump(slot.buckets[bucket_index(nanoseconds)], 1);
+}
+
+std::uint64_t FunctionMetrics::percentile(double q) const {
+    if (calls == 0 || buckets.empty()) {
+        return 0;
+    }
+    // Nearest rank: the smallest bucket covering ceil(q * calls) calls
+    std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(calls));
+    if (static_cast<double>(rank) < q * static_cast<double>(calls)) {
+        ++rank;
+    }
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < buckets.size(); ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            return bucket_upper_bound(b);
+        }
+    }
+    return bucket_upper_bound(buckets.size() - 1);
+}
+
+std::vector<FunctionMetrics> snapshot() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<FunctionMetrics> result;
+    for (std::size_t id = 0; id < r.names.size(); ++id) {
+        Totals totals = current_totals(r, id);
+        const Totals& base = r.baseline[id];
+        if (totals.calls <= base.calls) {
+            continue;
+        }
+        FunctionMetrics metrics;
+        metrics.name = r.names[id];
+        metrics.calls = totals.calls - base.calls;
+        metrics.errors = totals.errors - base.errors;
+        metrics.total_ns = totals.total_ns - base.total_ns;
+        metrics.buckets.resize(kBucketCount);
+        for (std::size_t b = 0; b < kBucketCount; ++b) {
+            metrics.buckets[b] = totals.buckets[b] - base.buckets[b];
+        }
+        result.push_back(std::move(metrics));
+    }
+    return result;
+}
+
+void reset() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (std::size_t id = 0; id < r.names.size(); ++id) {
+        r.baseline[id] = current_totals(r, id);
+    }
+}
+
+std::string prometheus_text(const std::string& prefix) {
+    const std::vector<FunctionMetrics> functions = snapshot();
+    std::string out;
+    auto label = [&out](const FunctionMetrics& f) {
+        out += "{function=\"";
+        format_label_value(out, f.name);
+        out += '"';
+    };
+
+    out += "# HELP " + prefix + "_calls_total Calls per function.\n";
+    out += "# TYPE " + prefix + "_calls_total counter\n";
+    for (const FunctionMetrics& f : functions) {
+        out += prefix + "_calls_total";
+        label(f);
+        out += "} " + std::to_string(f.calls) + "\n";
+    }
+    out += "# HELP " + prefix + "_errors_total Calls that raised an exception.\n";
+    out += "# TYPE " + prefix + "_errors_total counter\n";
+    for (const FunctionMetrics& f : functions) {
+        out += prefix + "_errors_total";
+        label(f);
+        out += "} " + std::to_string(f.errors) + "\n";
+    }
+
+    // Native buckets end just below powers of two, so cumulative counts at
+    // le = 2^e ns are exact. Every function gets the same ladder, 2^10 ns to
+    // 2^43 ns (the native range), on every scrape: rate() and
+    // histogram_quantile() need a fixed set of le series
+    const std::string histogram = prefix + "_call_duration_seconds";
+    out += "# HELP " + histogram + " Call latency.\n";
+    out += "# TYPE " + histogram + " histogram\n";
+    for (const FunctionMetrics& f : functions) {
+        std::uint64_t cumulative = 0;
+        std::size_t b = 0;
+        for (unsigned exponent = 10; exponent <= kMaxExponent + 1; ++exponent) {
+            const std::uint64_t bound = std::uint64_t(1) << exponent;
+            for (; b < kBucketCount && bucket_upper_bound(b) < bound; ++b) {
+                cumulative += f.buckets[b];
+            }
+            out += histogram + "_bucket";
+            label(f);
+            out += ",le=\"";
+            append_number(out, static_cast<double>(bound) * 1e-9);
+            out += "\"} " + std::to_string(cumulative) + "\n";
+        }
+        out += histogram + "_bucket";
+        label(f);
+        out += ",le=\"+Inf\"} " + std::to_string(f.calls) + "\n";
+        out += histogram + "_sum";
+        label(f);
+        out += "} ";
+        append_number(out, static_cast<double>(f.total_ns) * 1e-9);
+        out += "\n" + histogram + "_count";
+        label(f);
+        out += "} " + std::to_string(f.calls) + "\n";
+    }
+    return out;
+}
+
+} // namespace metrics
+} // namespace cpp_functions
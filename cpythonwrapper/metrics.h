@@ -0,0 +1,106 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Always-on call metrics for the Python bindings.
+ * Every thread records into its own shard of plain counters that only it
+ * writes, so recording a call is a handful of relaxed loads and stores with
+ * no locks or atomic read-modify-writes. Readers sum the shards. Latencies
+ * go into a log-linear (HDR-style) histogram with 8 sub-buckets per power of
+ * two, i.e. at most 12.5% relative error.
+ */
+
+namespace cpp_functions {
+namespace metrics {
+
+/** Most functions that can be registered. */
+constexpr std::size_t kMaxFunctions = 256;
+
+/** Histogram buckets: exact below 8 ns, log-linear up to 2^43 ns (~2.4 hours). */
+constexpr std::size_t kBucketCount = 328;
+
+/**
+ * Id for the function called name, registering it on first use.
+ * Throws std::length_error once kMaxFunctions names are registered.
+ */
+std::size_t register_function(const std::string& name);
+
+/** Record one call of function id that took nanoseconds. */
+void record(std::size_t id, std::uint64_t nanoseconds, bool failed);
+
+/** Histogram bucket holding a latency of nanoseconds. */
+std::size_t bucket_index(std::uint64_t nanoseconds);
+
+/** Largest latency, in nanoseconds, that falls in bucket. */
+std::uint64_t bucket_upper_bound(std::size_t bucket);
+
+/**
+ * Totals of one function since the last reset().
+ */
+struct FunctionMetrics {
+    std::string name;
+    std::uint64_t calls = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t total_ns = 0;
+    std::vector<std::uint64_t> buckets;  // kBucketCount counts
+
+    /** Upper bound of the bucket holding quantile q (0..1); 0 without calls. */
+    std::uint64_t percentile(double q) const;
+};
+
+/**
+ * Every function called at least once since the last reset(), in
+ * registration order. Counters are read without stopping writers, so a
+ * call finishing concurrently may be partly included.
+ */
+std::vector<FunctionMetrics> snapshot();
+
+/**
+ * Start counting from zero again. Writers are not disturbed: the current
+ * totals become the baseline later snapshots are taken against.
+ */
+void reset();
+
+/**
+ * snapshot() in the Prometheus text exposition format: a calls and an
+ * errors counter and a latency histogram (seconds, a fixed bucket at
+ * every power of two from ~1 us to ~2.4 h) per function, labelled
+ * function="name".
+ */
+std::string prometheus_text(const std::string& prefix = "cpp_accelerated");
+
+/**
+ * Times its own lifetime and records it for a function; fail() marks the
+ * call as having raised.
+ */
+class CallTimer {
+public:
+    explicit CallTimer(std::size_t id) : id_(id), start_(std::chrono::steady_clock::now()) {}
+    ~CallTimer() {
+        const auto elapsed = std::chrono::steady_clock::now() - start_;
+        record(id_, static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+               failed_);
+    }
+
+    CallTimer(const CallTimer&) = delete;
+    CallTimer& operator=(const CallTimer&) = delete;
+
+    void fail() { failed_ = true; }
+
+private:
+    std::size_t id_;
+    std::chrono::steady_clock::time_point start_;
+    bool failed_ = false;
+};
+
+} // namespace metrics
+} // namespace cpp_functions
+
+#endif // METRICS_H
@@ -0,0 +1,208 @@
+#include "perf_counters.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define CPP_FUNCTIONS_HAVE_PERF_EVENT 1
+#endif
+
+/**
+ * perf_event_open backend. Events are opened individually rather than as
+ * one group: a group that does not fit the PMU is never scheduled, while
+ * single events are multiplexed and can be scaled by enabled/running time.
+ */
+
+namespace cpp_functions {
+namespace perf {
+
+namespace {
+
+const char* const kEventNames[kEventCount] = {
+    "cycles",       "instructions", "cache_references", "cache_misses",    "branch_instructions",
+    "branch_misses", "task_clock",  "page_faults",      "context_switches",
+};
+
+#if defined(CPP_FUNCTIONS_HAVE_PERF_EVENT)
+
+struct EventSpec {
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+const EventSpec kEventSpecs[kEventCount] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+};
+
+/** Layout of read() with TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING. */
+struct EventValue {
+    std::uint64_t value;
+    std::uint64_t enabled;
+    std::uint64_t running;
+};
+
+/**
+ * The calling thread's counters. Descriptors follow the thread that opened
+ * them, so a child created by fork() reopens its own on first use.
+ */
+class ThreadCounters {
+public:
+    ThreadCounters() { open(); }
+    ~ThreadCounters() { close(); }
+
+    ThreadCounters(const ThreadCounters&) = delete;
+    ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+    static ThreadCounters& current() {
+        thread_local ThreadCounters counters;
+        if (counters.pid_ != getpid()) {
+            counters.close();
+            counters.open();
+        }
+        return counters;
+    }
+
+    bool hardware() const { return hardware_; }
+    const std::string& error() const { return error_; }
+
+    void start() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    void stop(Reading& reading) {
+        for (std::size_t i = 0; i < kEventCount; ++i) {
+            if (fds_[i] >= 0) {
+                ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (std::size_t i = 0; i < kEventCount; ++i) {
+            EventValue v;
+            if (fds_[i] < 0 || read(fds_[i], &v, sizeof(v)) != static_cast<ssize_t>(sizeof(v))) {
+                continue;
+            }
+            double value = static_cast<double>(v.value);
+            if (v.running > 0 && v.running < v.enabled) {
+                value *= static_cast<double>(v.enabled) / static_cast<double>(v.running);
+            }
+            reading.supported[i] = true;
+            reading.values[i] = value;
+        }
+    }
+
+private:
+    void open() {
+        pid_ = getpid();
+        hardware_ = false;
+        error_.clear();
+        for (std::size_t i = 0; i < kEventCount; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = kEventSpecs[i].type;
+            attr.config = kEventSpecs[i].config;
+            attr.disabled = 1;
+            // User space only, which perf_event_paranoid = 2 still allows
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+            if (fds_[i] >= 0) {
+                hardware_ |= kEventSpecs[i].type == PERF_TYPE_HARDWARE;
+            } else if (kEventSpecs[i].type == PERF_TYPE_HARDWARE && error_.empty()) {
+                error_ = std::string("perf_event_open: ") + std::strerror(errno);
+            }
+        }
+        if (hardware_) {
+            error_.clear();
+        }
+    }
+
+    void close() {
+        for (int& fd : fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            fd = -1;
+        }
+    }
+
+    int fds_[kEventCount];
+    pid_t pid_ = 0;
+    bool hardware_ = false;
+    std::string error_;
+};
+
+#endif // CPP_FUNCTIONS_HAVE_PERF_EVENT
+
+} // namespace
+
+const char* event_name(Event event) {
+    return kEventNames[static_cast<std::size_t>(event)];
+}
+
+bool available() {
+#if defined(CPP_FUNCTIONS_HAVE_PERF_EVENT)
+    return ThreadCounters::current().hardware();
+#else
+    return false;
+#endif
+}
+
+Reading count(const std::function<void()>& body, unsigned calls) {
+    if (calls == 0) {
+        throw std::invalid_argument("perf: calls must be positive");
+    }
+    Reading reading;
+    reading.calls = calls;
+#if defined(CPP_FUNCTIONS_HAVE_PERF_EVENT)
+    ThreadCounters& counters = ThreadCounters::current();
+    reading.error = counters.error();
+    const auto start = std::chrono::steady_clock::now();
+    counters.start();
+    try {
+        for (unsigned i = 0; i < calls; ++i) {
+            body();
+        }
+    } catch (...) {
+        Reading discarded;
+        counters.stop(discarded);
+        throw;
+    }
+    counters.stop(reading);
+    const auto end = std::chrono::steady_clock::now();
+#else
+    reading.error = "hardware counters need Linux perf_event_open";
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < calls; ++i) {
+        body();
+    }
+    const auto end = std::chrono::steady_clock::now();
+#endif
+    reading.seconds = std::chrono::duration<double>(end - start).count() / calls;
+    for (double& value : reading.values) {
+        value /= calls;
+    }
+    return reading;
+}
+
+} // namespace perf
+} // namespace cpp_functions
@@ -0,0 +1,68 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * Hardware performance counters around a kernel call.
+ * On Linux each event is a perf_event_open counter of the calling thread,
+ * user space only, opened once per thread and reused. Events the CPU,
+ * kernel or perf_event_paranoid setting refuse are reported as
+ * unsupported; on other platforms every event is, and count() only times
+ * the call.
+ */
+
+namespace cpp_functions {
+namespace perf {
+
+enum class Event {
+    cycles,
+    instructions,
+    cache_references,     // last-level cache accesses
+    cache_misses,         // last-level cache misses
+    branch_instructions,
+    branch_misses,
+    task_clock,           // nanoseconds on CPU (software event)
+    page_faults,          // software event
+    context_switches,     // software event
+};
+
+constexpr std::size_t kEventCount = 9;
+
+/** Snake-case name of event, as used for the keys of the Python dict. */
+const char* event_name(Event event);
+
+/**
+ * Counts for count(), divided by the number of calls. Values are scaled up
+ * when the kernel multiplexed the counter with other events.
+ */
+struct Reading {
+    bool supported[kEventCount] = {};
+    double values[kEventCount] = {};
+    double seconds = 0;     // wall time per call
+    unsigned calls = 0;
+    std::string error;      // why no hardware event could be opened, if none was
+
+    bool has(Event event) const { return supported[static_cast<std::size_t>(event)]; }
+    double value(Event event) const { return values[static_cast<std::size_t>(event)]; }
+};
+
+/**
+ * True when at least one hardware event can be counted on this thread.
+ */
+bool available();
+
+/**
+ * Run body calls times with the calling thread's counters enabled.
+ * Only the calling thread is counted: work a kernel hands to pool threads
+ * is not, so measure parallel kernels with threads=1.
+ */
+Reading count(const std::function<void()>& body, unsigned calls = 1);
+
+} // namespace perf
+} // namespace cpp_functions
+
+#endif // PERF_COUNTERS_H
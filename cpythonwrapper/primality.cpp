@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "cpp_functions.h"
+#include "prime_table.h"
+#include "scratch.h"
+#include "small_tables.h"
+
+/**
+ * Deterministic primality test for 64-bit integers.
+ * Values up to 65536 or inside the active prime table are looked up. The
+ * rest are screened for odd prime factors below 64 (a multiply and a
+ * compare each), then run through Miller-Rabin in Montgomery form with a
+ * base set proven correct for their size: {2, 7, 61} below 2^32 and Jim
+ * Sinclair's seven bases for the whole 64-bit range. Nothing depends on
+ * the size of n beyond those two sets, so the cost per value is nearly
+ * constant.
+ */
+
+namespace cpp_functions {
+
+namespace {
+
+using u128 = unsigned __int128;
+
+/** n^-1 mod 2^64 for odd n: Newton's iteration doubles the correct bits. */
+constexpr std::uint64_t inverse64(std::uint64_t n) {
+    std::uint64_t x = (3 * n) ^ 2;  // correct to 5 bits
+    for (int i = 0; i < 4; ++i) {
+        x *= 2 - n * x;
+    }
+    return x;
+}
+
+constexpr std::uint32_t kScreenPrimes[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61};
+constexpr std::size_t kScreenCount = sizeof(kScreenPrimes) / sizeof(kScreenPrimes[0]);
+
+/**
+ * For odd p, p divides n exactly when n p^-1 mod 2^64 <= (2^64 - 1) / p,
+ * which tests divisibility without a division.
+ */
+struct Screen {
+    std::uint64_t inverse[kScreenCount] = {};
+    std::uint64_t limit[kScreenCount] = {};
+};
+
+constexpr Screen make_screen() {
+    Screen screen;
+    for (std::size_t i = 0; i < kScreenCount; ++i) {
+        screen.inverse[i] = inverse64(kScreenPrimes[i]);
+        screen.limit[i] = ~std::uint64_t(0) / kScreenPrimes[i];
+    }
+    return screen;
+}
+
+constexpr Screen kScreen = make_screen();
+
+/** True when n > 61 has an odd prime factor below 64. */
+bool has_small_factor(std::uint64_t n) {
+    bool found = false;
+    for (std::size_t i = 0; i < kScreenCount; ++i) {
+        found |= n * kScreen.inverse[i] <= kScreen.limit[i];
+    }
+    return found;
+}
+
+constexpr std::uint64_t kBases32[] = {2, 7, 61};
+constexpr std::uint64_t kBases64[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+constexpr int kMaxBases = sizeof(kBases64) / sizeof(kBases64[0]);
+
+/** Arithmetic modulo an odd n with x held as x 2^64 mod n. */
+struct Montgomery {
+    std::uint64_t n;
+    std::uint64_t inv;  // n^-1 mod 2^64
+    std::uint64_t one;  // 2^64 mod n
+    std::uint64_t r2;   // 2^128 mod n
+
+    explicit Montgomery(std::uint64_t modulus)
+        : n(modulus), inv(inverse64(modulus)), one((0 - modulus) % modulus),
+          r2(static_cast<std::uint64_t>(u128(one) * one % modulus)) {}
+
+    /** a b 2^-64 mod n for a, b < n. The low halves of a b and m n cancel exactly. */
+    std::uint64_t mul(std::uint64_t a, std::uint64_t b) const {
+        const u128 t = u128(a) * b;
+        const std::uint64_t m = static_cast<std::uint64_t>(t) * inv;
+        const std::uint64_t mn = static_cast<std::uint64_t>((u128(m) * n) >> 64);
+        const std::uint64_t hi = static_cast<std::uint64_t>(t >> 64);
+        // Masked rather than branched: the borrow is a coin flip
+        return hi - mn + (n & (0 - std::uint64_t(hi < mn)));
+    }
+
+    std::uint64_t to(std::uint64_t a) const { return mul(a % n, r2); }
+};
+
+/** Odd n > 65536 awaiting Miller-Rabin, with n - 1 = d 2^s. */
+struct Candidate {
+    Montgomery mont;
+    std::uint64_t d;
+    int s;
+    int bases;      // size of the base set n needs
+    std::size_t index;
+
+    Candidate(std::uint64_t value, std::size_t i) : mont(value), d(value - 1), s(0), index(i) {
+        while (d % 2 == 0) {
+            d /= 2;
+            ++s;
+        }
+        bases = value >> 32 == 0 ? 3 : kMaxBases;
+    }
+
+    std::uint64_t base(int round) const { return bases == 3 ? kBases32[round] : kBases64[round]; }
+};
+
+/** Finish a strong probable-prime round from x = a^d: true unless a witnesses compositeness. */
+bool passes_squarings(const Candidate& c, std::uint64_t x) {
+    const std::uint64_t minus_one = c.mont.n - c.mont.one;
+    if (x == c.mont.one || x == minus_one) {
+        return true;
+    }
+    for (int r = 1; r < c.s; ++r) {
+        x = c.mont.mul(x, x);
+        if (x == minus_one) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Round `round` of Miller-Rabin for L candidates at once: a^d by fixed
+ * 4-bit windows, every lane stepping through as many windows as the
+ * longest exponent needs (leading zero windows multiply by one). The L
+ * multiply chains are independent, so they overlap in the pipeline;
+ * 64x64 -> 128-bit products have no SIMD form on x86 or NEON, so the lanes
+ * run as interleaved scalar code rather than vector code.
+ */
+template <int L>
+void test_lanes(const Candidate* c, int round, bool* passed) {
+    std::uint64_t power[L][16];
+    std::uint64_t top = 0;
+    for (int l = 0; l < L; ++l) {
+        const std::uint64_t a = c[l].base(round) % c[l].mont.n;
+        // A base that is a multiple of n proves nothing: use a = 1 so the round passes
+        power[l][0] = c[l].mont.one;
+        power[l][1] = a == 0 ? c[l].mont.one : c[l].mont.to(a);
+        top |= c[l].d;
+    }
+    for (int k = 2; k < 16; ++k) {
+        for (int l = 0; l < L; ++l) {
+            power[l][k] = c[l].mont.mul(power[l][k - 1], power[l][1]);
+        }
+    }
+    int shift = (63 - __builtin_clzll(top)) / 4 * 4;
+    std::uint64_t x[L];
+    for (int l = 0; l < L; ++l) {
+        x[l] = power[l][(c[l].d >> shift) & 15];
+    }
+    for (shift -= 4; shift >= 0; shift -= 4) {
+        for (int l = 0; l < L; ++l) {
+            std::uint64_t y = c[l].mont.mul(x[l], x[l]);
+            y = c[l].mont.mul(y, y);
+            y = c[l].mont.mul(y, y);
+            y = c[l].mont.mul(y, y);
+            x[l] = c[l].mont.mul(y, power[l][(c[l].d >> shift) & 15]);
+        }
+    }
+    for (int l = 0; l < L; ++l) {
+        passed[l] = passes_squarings(c[l], x[l]);
+    }
+}
+
+/** Candidates tested side by side in one batch group. */
+constexpr int kLanes = 4;
+
+/**
+ * Run every base round over candidates[0, count): composites get false in
+ * out and drop out, candidates that exhaust their base set get true.
+ */
+void miller_rabin_batch(Candidate* candidates, std::size_t count, bool* out) {
+    for (int round = 0; round < kMaxBases && count > 0; ++round) {
+        bool passed[kLanes];
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < count; i += kLanes) {
+            const std::size_t group = std::min<std::size_t>(kLanes, count - i);
+            if (group == kLanes) {
+                test_lanes<kLanes>(candidates + i, round, passed);
+            } else {
+                for (std::size_t l = 0; l < group; ++l) {
+                    test_lanes<1>(candidates + i + l, round, passed + l);
+                }
+            }
+            for (std::size_t l = 0; l < group; ++l) {
+                const Candidate& c = candidates[i + l];
+                if (!passed[l]) {
+                    out[c.index] = false;
+                } else if (round + 1 == c.bases) {
+                    out[c.index] = true;
+                } else {
+                    candidates[kept++] = c;
+                }
+            }
+        }
+        count = kept;
+    }
+}
+
+} // namespace
+
+bool is_prime(std::uint64_t n) {
+    if (n <= small::kPrimeTableLimit) {
+        return small::kPrimes.is_prime(static_cast<std::uint32_t>(n));
+    }
+    if (n % 2 == 0 || has_small_factor(n)) {
+        return false;
+    }
+    const std::shared_ptr<const sieve::PrimeTable> table = sieve::active_table();
+    if (table && n <= table->limit()) {
+        return table->is_prime(n);
+    }
+    Candidate c(n, 0);
+    for (int round = 0; round < c.bases; ++round) {
+        bool passed;
+        test_lanes<1>(&c, round, &passed);
+        if (!passed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void is_prime_batch(const std::uint64_t* in, bool* out, std::size_t n) {
+    const std::shared_ptr<const sieve::PrimeTable> table = sieve::active_table();
+    const std::uint64_t table_limit = table ? table->limit() : 0;
+    // Screen everything first, then run Miller-Rabin over the survivors only
+    scratch::Array<Candidate> pending(n);
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint64_t value = in[i];
+        if (value <= small::kPrimeTableLimit) {
+            out[i] = small::kPrimes.is_prime(static_cast<std::uint32_t>(value));
+        } else if (value % 2 == 0 || has_small_factor(value)) {
+            out[i] = false;
+        } else if (value <= table_limit) {
+            out[i] = table->is_prime(value);
+        } else {
+            pending[count++] = Candidate(value, i);
+        }
+    }
+    miller_rabin_batch(pending.data(), count, out);
+}
+
+} // namespace cpp_functions
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "cancellation.h"
+#include "cpp_functions.h"
+#include "prime_table.h"
+#include "scratch.h"
+#include "segmented_sieve.h"
+#include "small_tables.h"
+
+/**
+ * Meissel-Lehmer prime counting.
+ * pi(x) = phi(x, a) + a - 1 - P2(x, a) with a = pi(x^(1/3)); composites are
+ * counted combinatorially so only primes up to x^(2/3) are ever sieved.
+ */
+
+namespace cpp_functions {
+
+namespace {
+
+using sieve::isqrt;
+
+/** Below this limit plain sieving is faster than the combinatorial method. */
+constexpr std::uint64_t kSieveCutoff = 1000000;
+
+/** Number of leading primes whose phi values come from a periodic table. */
+constexpr std::size_t kSmallA = 6;
+constexpr std::array<std::uint32_t, kSmallA> kSmallPrimes = {{2, 3, 5, 7, 11, 13}};
+
+std::uint64_t icbrt(std::uint64_t n) {
+    std::uint64_t r = 0;
+    for (int shift = 63; shift >= 0; shift -= 3) {
+        r <<= 1;
+        std::uint64_t b = 3 * r * (r + 1) + 1;
+        if ((n >> shift) >= b) {
+            n -= b << shift;
+            ++r;
+        }
+    }
+    return r;
+}
+
+/**
+ * phi(x, k) for k <= kSmallA via the primorial period:
+ * phi(x, k) = (x / P_k) * totient(P_k) + phi(x mod P_k, k).
+ */
+class SmallPhi {
+public:
+    SmallPhi() {
+        std::uint32_t primorial = 1;
+        for (std::size_t k = 0; k <= kSmallA; ++k) {
+            primorial_[k] = primorial;
+            std::vector<std::uint16_t>& table = tables_[k];
+            table.resize(primorial);
+            std::uint16_t count = 0;
+            for (std::uint32_t r = 0; r < primorial; ++r) {
+                bool coprime = r > 0;
+                for (std::size_t i = 0; i < k && coprime; ++i) {
+                    coprime = r % kSmallPrimes[i] != 0;
+                }
+                count += coprime ? 1 : 0;
+                table[r] = count;
+            }
+            totient_[k] = count;
+            if (k < kSmallA) {
+                primorial *= kSmallPrimes[k];
+            }
+        }
+    }
+
+    std::uint64_t operator()(std::uint64_t x, std::size_t k) const {
+        return (x / primorial_[k]) * totient_[k] + tables_[k][x % primorial_[k]];
+    }
+
+private:
+    std::array<std::uint32_t, kSmallA + 1> primorial_;
+    std::array<std::uint32_t, kSmallA + 1> totient_;
+    std::array<std::vector<std::uint16_t>, kSmallA + 1> tables_;
+};
+
+/**
+ * pi(y) lookups for y <= limit: one bit per odd number plus a running
+ * count before each 64-bit word, answered with a single popcount.
+ */
+class PiTable {
+public:
+    explicit PiTable(std::uint64_t limit) : limit_(limit) {
+        std::size_t words = static_cast<std::size_t>(limit / 128 + 1);
+        bits_ = scratch::Array<std::uint64_t>(words);
+        prefix_ = scratch::Array<std::uint32_t>(words);
+        std::fill(bits_.data(), bits_.data() + words, std::uint64_t(0));
+
+        sieve::SegmentedSieve s(3, limit);
+        while (s.next()) {
+            s.for_each_prime([this](std::uint64_t p) {
+                std::uint64_t i = p / 2;
+                bits_[static_cast<std::size_t>(i / 64)] |= std::uint64_t(1) << (i % 64);
+            });
+        }
+
+        std::uint32_t running = 0;
+        for (std::size_t w = 0; w < words; ++w) {
+            prefix_[w] = running;
+            running += static_cast<std::uint32_t>(__builtin_popcountll(bits_[w]));
+        }
+    }
+
+    std::uint64_t operator()(std::uint64_t y) const {
+        if (y < 2) {
+            return 0;
+        }
+        // Odd numbers 1, 3, ..., y map to bit indices 0 .. (y - 1) / 2
+        std::uint64_t i = (y - 1) / 2;
+        std::size_t w = static_cast<std::size_t>(i / 64);
+        std::uint64_t mask = (std::uint64_t(2) << (i % 64)) - 1;
+        return 1 + prefix_[w] + __builtin_popcountll(bits_[w] & mask);
+    }
+
+    std::uint64_t limit() const { return limit_; }
+
+private:
+    std::uint64_t limit_;
+    scratch::Array<std::uint64_t> bits_;
+    scratch::Array<std::uint32_t> prefix_;
+};
+
+class MeisselLehmer {
+public:
+    MeisselLehmer(const std::vector<std::uint32_t>& primes, const PiTable& pi)
+        : primes_(primes), pi_(pi) {}
+
+    /**
+     * phi(x, a): integers in [1, x] with no prime factor among the first a
+     * primes, via phi(x, a) = phi(x, a - 1) - phi(x / p_a, a - 1).
+     */
+    std::uint64_t phi(std::uint64_t x, std::size_t a) const {
+        if (a <= kSmallA) {
+            return small_phi_(x, a);
+        }
+        if (x <= primes_[a - 1]) {
+            return x >= 1 ? 1 : 0;
+        }
+        // Once p_(a+1)^2 > x only 1 and the primes above p_a survive
+        std::uint64_t next_prime = primes_[a];
+        if (x < next_prime * next_prime) {
+            return pi_(x) - a + 1;
+        }
+
+        std::uint64_t result = small_phi_(x, kSmallA);
+        for (std::size_t i = kSmallA; i < a; ++i) {
+            std::uint64_t p = primes_[i];
+            if (p * p > x) {
+                // phi(x / p, i) == 1 for all remaining primes
+                result -= a - i;
+                break;
+            }
+            cancellation_point();
+            result -= phi(x / p, i);
+        }
+        return result;
+    }
+
+private:
+    const std::vector<std::uint32_t>& primes_;  // includes 2
+    const PiTable& pi_;
+    SmallPhi small_phi_;
+};
+
+} // namespace
+
+/**
+ * Count primes <= x with the Meissel-Lehmer method in O(x^(2/3)) time.
+ * Small x falls back to the segmented sieve, or is looked up when the active
+ * prime table covers it.
+ */
+long long prime_pi(long long x) {
+    if (x < 2) {
+        return 0;
+    }
+    std::uint64_t n = static_cast<std::uint64_t>(x);
+    if (n <= small::kPrimeTableLimit) {
+        return small::kPrimes.count(static_cast<std::uint32_t>(n));
+    }
+    const std::shared_ptr<const sieve::PrimeTable> table = sieve::active_table();
+    if (table && n <= table->limit()) {
+        return static_cast<long long>(table->count(n));
+    }
+    if (n < kSieveCutoff) {
+        return static_cast<long long>(sieve::count_primes(2, n));
+    }
+
+    std::uint64_t root2 = isqrt(n);
+    std::uint64_t root3 = icbrt(n);
+
+    // Primes up to sqrt(x); p_(a+1) is among them since x^(1/3) << sqrt(x)
+    std::vector<std::uint32_t> primes;
+    primes.push_back(2);
+    for (std::uint32_t p : sieve::base_primes(n)) {
+        primes.push_back(p);
+    }
+    std::size_t a = static_cast<std::size_t>(
+        std::upper_bound(primes.begin(), primes.end(), root3) - primes.begin());
+    std::size_t b = static_cast<std::size_t>(
+        std::upper_bound(primes.begin(), primes.end(), root2) - primes.begin());
+    if (primes.size() <= std::max(a, kSmallA)) {
+        throw std::logic_error("prime_pi: base prime table too small");
+    }
+
+    // pi(y) is needed for y <= x / p_(a+1) (P2 term) and y < p_(a+1)^2 (phi)
+    std::uint64_t p_next = primes[a];
+    PiTable pi(std::max(n / p_next, p_next * p_next));
+
+    MeisselLehmer ml(primes, pi);
+    std::uint64_t result = ml.phi(n, a) + a - 1;
+
+    // P2(x, a): numbers <= x with exactly two prime factors, both > p_a
+    for (std::size_t i = a; i < b; ++i) {
+        result -= pi(n / primes[i]) - i;
+    }
+    return static_cast<long long>(result);
+}
+
+} // namespace cpp_functions
@@ -0,0 +1,438 @@
+#include "prime_table.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+#include "segmented_sieve.h"
+#include "thread_pool.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CPP_PRIME_TABLE_MMAP 1
+#endif
+
+/**
+ * File layout, version 1, in native byte order: a 64-byte Header, the
+ * bitmap (words 64-bit words), then one 64-bit running count per block.
+ * The checksum covers everything after the header. A table built in
+ * memory uses the same image, so save() writes it out unchanged.
+ */
+
+namespace cpp_functions {
+namespace sieve {
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'P', 'P', 'P', 'R', 'I', 'M', 'E'};
+
+/** Reads back byte-swapped when the file was written on the other endianness. */
+constexpr std::uint32_t kEndianMark = 0x01020304;
+
+/** Values each build chunk sieves; a multiple of 128 so chunks own whole words. */
+constexpr std::uint64_t kBuildSpan = std::uint64_t(1) << 24;
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endian;
+    std::uint64_t limit;
+    std::uint64_t words;
+    std::uint64_t blocks;
+    std::uint64_t primes;    // pi(limit)
+    std::uint64_t checksum;  // of the bitmap and counts
+    std::uint32_t block_words;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 64, "prime table header layout");
+
+std::uint64_t words_for(std::uint64_t limit) {
+    return limit / 128 + 1;
+}
+
+std::uint64_t blocks_for(std::uint64_t words) {
+    return (words + kPrimeTableBlockWords - 1) / kPrimeTableBlockWords;
+}
+
+std::size_t image_bytes(std::uint64_t words, std::uint64_t blocks) {
+    return sizeof(Header) + static_cast<std::size_t>(words + blocks) * sizeof(std::uint64_t);
+}
+
+/**
+ * Multiply-xorshift hash over 64-bit words. Four independent lanes keep
+ * the multiplier busy, so verifying a 1e9 table costs milliseconds. Not
+ * cryptographic: it catches truncation and corruption, not tampering.
+ */
+std::uint64_t checksum(const std::uint64_t* data, std::size_t n) {
+    constexpr std::uint64_t kMul = 0x9E3779B97F4A7C15ULL;
+    std::uint64_t lane[4] = {0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL,
+                             0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            const std::uint64_t x = (lane[k] ^ data[i + k]) * kMul;
+            lane[k] = x ^ (x >> 29);
+        }
+    }
+    for (; i < n; ++i) {
+        const std::uint64_t x = (lane[0] ^ data[i]) * kMul;
+        lane[0] = x ^ (x >> 29);
+    }
+    std::uint64_t h = n;
+    for (int k = 0; k < 4; ++k) {
+        h = (h ^ lane[k]) * kMul;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+/**
+ * OR n sieve flags (one byte each, 0 or 1) into bits from bit index first
+ * on. Whole words are packed eight flags per multiply: the constant moves
+ * byte k's low bit to bit 56 + k without any two products overlapping.
+ */
+void pack_flags(const std::uint8_t* flags, std::size_t n, std::uint64_t first, std::uint64_t* bits) {
+    constexpr std::uint64_t kGather = 0x0102040810204080ULL;
+    std::size_t i = 0;
+    for (; i < n && (first + i) % 64 != 0; ++i) {
+        bits[(first + i) / 64] |= std::uint64_t(flags[i]) << ((first + i) % 64);
+    }
+    for (; i + 64 <= n; i += 64) {
+        std::uint64_t word = 0;
+        for (int b = 0; b < 8; ++b) {
+            std::uint64_t lanes;
+            std::memcpy(&lanes, flags + i + 8 * b, sizeof(lanes));
+            word |= ((lanes * kGather) >> 56) << (8 * b);
+        }
+        bits[(first + i) / 64] = word;
+    }
+    for (; i < n; ++i) {
+        bits[(first + i) / 64] |= std::uint64_t(flags[i]) << ((first + i) % 64);
+    }
+}
+
+[[noreturn]] void fail(const std::string& path, const char* reason) {
+    throw std::runtime_error("prime table " + path + ": " + reason);
+}
+
+void release_image(void* base, std::size_t bytes, bool mapped) {
+#if defined(CPP_PRIME_TABLE_MMAP)
+    if (mapped) {
+        munmap(base, bytes);
+        return;
+    }
+#else
+    (void)bytes;
+    (void)mapped;
+#endif
+    aligned_deallocate(base);
+}
+
+/** Throw unless the bytes-long image at base is a complete table of this version. */
+void validate(const std::string& path, const void* base, std::size_t bytes, bool verify) {
+    if (bytes < sizeof(Header)) {
+        fail(path, "truncated header");
+    }
+    const Header* header = static_cast<const Header*>(base);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+        fail(path, "not a prime table");
+    }
+    if (header->endian != kEndianMark) {
+        fail(path, "written with a different byte order");
+    }
+    if (header->version != kPrimeTableVersion || header->block_words != kPrimeTableBlockWords) {
+        fail(path, "unsupported format version");
+    }
+    if (header->limit > kPrimeTableMaxLimit || header->words != words_for(header->limit) ||
+        header->blocks != blocks_for(header->words) ||
+        bytes != image_bytes(header->words, header->blocks)) {
+        fail(path, "size does not match its header");
+    }
+    const std::uint64_t* payload = reinterpret_cast<const std::uint64_t*>(header + 1);
+    if (verify && checksum(payload, static_cast<std::size_t>(header->words + header->blocks)) !=
+                      header->checksum) {
+        fail(path, "checksum mismatch");
+    }
+}
+
+std::mutex g_active_mutex;
+std::shared_ptr<const PrimeTable> g_active;
+
+} // namespace
+
+PrimeTable::PrimeTable(void* base, std::size_t bytes, bool mapped)
+    : base_(base), bytes_(bytes), mapped_(mapped) {
+    const Header* header = static_cast<const Header*>(base_);
+    bits_ = reinterpret_cast<const std::uint64_t*>(header + 1);
+    counts_ = bits_ + header->words;
+    limit_ = header->limit;
+    total_ = header->primes;
+}
+
+PrimeTable::~PrimeTable() {
+    release_image(base_, bytes_, mapped_);
+}
+
+std::shared_ptr<const PrimeTable> PrimeTable::adopt(void* base, std::size_t bytes, bool mapped) {
+    PrimeTable* table;
+    try {
+        table = new PrimeTable(base, bytes, mapped);
+    } catch (...) {
+        release_image(base, bytes, mapped);
+        throw;
+    }
+    return std::shared_ptr<const PrimeTable>(table);
+}
+
+std::shared_ptr<const PrimeTable> PrimeTable::build(std::uint64_t limit, unsigned threads) {
+    if (limit > kPrimeTableMaxLimit) {
+        throw std::invalid_argument("prime table limit must be <= 2**36");
+    }
+    const std::uint64_t words = words_for(limit);
+    const std::uint64_t blocks = blocks_for(words);
+    const std::size_t bytes = image_bytes(words, blocks);
+    std::unique_ptr<void, void (*)(void*)> image(aligned_allocate(bytes), &aligned_deallocate);
+    std::memset(image.get(), 0, bytes);
+
+    Header* header = static_cast<Header*>(image.get());
+    std::uint64_t* bits = reinterpret_cast<std::uint64_t*>(header + 1);
+    std::uint64_t* counts = bits + words;
+
+    // Chunks own disjoint words of the bitmap, so they are filled without locks
+    const std::vector<std::uint32_t> primes = base_primes(limit);
+    parallel_for(static_cast<std::size_t>(limit / kBuildSpan + 1), threads, [&](std::size_t c) {
+        const std::uint64_t lo = std::max<std::uint64_t>(c * kBuildSpan, 3);
+        const std::uint64_t hi = std::min(limit, (c + 1) * kBuildSpan - 1);
+        if (hi < lo) {
+            return;
+        }
+        SegmentedSieve sieve(lo, hi, primes);
+        while (sieve.next()) {
+            pack_flags(sieve.segment_flags(), sieve.segment_length(), sieve.segment_low() / 2, bits);
+        }
+    });
+
+    std::uint64_t running = 0;
+    for (std::uint64_t b = 0; b < blocks; ++b) {
+        counts[b] = running;
+        const std::uint64_t end = std::min<std::uint64_t>((b + 1) * kPrimeTableBlockWords, words);
+        for (std::uint64_t w = b * kPrimeTableBlockWords; w < end; ++w) {
+            running += static_cast<std::uint64_t>(__builtin_popcountll(bits[w]));
+        }
+    }
+
+    std::memcpy(header->magic, kMagic, sizeof(kMagic));
+    header->version = kPrimeTableVersion;
+    header->endian = kEndianMark;
+    header->limit = limit;
+    header->words = words;
+    header->blocks = blocks;
+    header->primes = limit >= 2 ? running + 1 : 0;
+    header->block_words = kPrimeTableBlockWords;
+    header->checksum = checksum(bits, static_cast<std::size_t>(words + blocks));
+    return adopt(image.release(), bytes, false);
+}
+
+std::shared_ptr<const PrimeTable> PrimeTable::open(const std::string& path, bool verify) {
+#if defined(CPP_PRIME_TABLE_MMAP)
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fail(path, std::strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        const int error = errno;
+        ::close(fd);
+        fail(path, std::strerror(error));
+    }
+    const std::size_t bytes = static_cast<std::size_t>(st.st_size);
+    if (bytes < sizeof(Header)) {
+        ::close(fd);
+        fail(path, "truncated header");
+    }
+    void* base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    const int error = errno;
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        fail(path, std::strerror(error));
+    }
+    try {
+        validate(path, base, bytes, verify);
+    } catch (...) {
+        munmap(base, bytes);
+        throw;
+    }
+    return adopt(base, bytes, true);
+#else
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        fail(path, "cannot open");
+    }
+    std::vector<char> contents;
+    char chunk[1 << 16];
+    std::size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        contents.insert(contents.end(), chunk, chunk + got);
+    }
+    const bool read_failed = std::ferror(file) != 0;
+    std::fclose(file);
+    if (read_failed) {
+        fail(path, "read error");
+    }
+    validate(path, contents.data(), contents.size(), verify);
+    void* base = aligned_allocate(contents.size());
+    std::memcpy(base, contents.data(), contents.size());
+    return adopt(base, contents.size(), false);
+#endif
+}
+
+std::uint64_t PrimeTable::count(std::uint64_t lo, std::uint64_t hi) const {
+    if (hi > limit_) {
+        throw std::out_of_range("prime table: range ends beyond the table limit");
+    }
+    if (hi < lo) {
+        return 0;
+    }
+    return count(hi) - (lo > 0 ? count(lo - 1) : 0);
+}
+
+std::uint64_t PrimeTable::nth(std::uint64_t k) const {
+    if (k == 0 || k > total_) {
+        throw std::out_of_range("prime table: no such prime within the table limit");
+    }
+    if (k == 1) {
+        return 2;
+    }
+    // Find the block holding the rank-th odd prime: the last one with fewer before it
+    std::uint64_t rank = k - 1;
+    const Header* header = static_cast<const Header*>(base_);
+    const std::uint64_t* block = std::lower_bound(counts_, counts_ + header->blocks, rank) - 1;
+    rank -= *block;
+    std::uint64_t w = static_cast<std::uint64_t>(block - counts_) * kPrimeTableBlockWords;
+    for (;; ++w) {
+        const std::uint64_t ones = static_cast<std::uint64_t>(__builtin_popcountll(bits_[w]));
+        if (rank <= ones) {
+            break;
+        }
+        rank -= ones;
+    }
+    std::uint64_t word = bits_[w];
+    for (; rank > 1; --rank) {
+        word &= word - 1;
+    }
+    return 2 * (w * 64 + static_cast<std::uint64_t>(__builtin_ctzll(word))) + 1;
+}
+
+std::uint64_t PrimeTable::next_prime(std::uint64_t x) const {
+    if (x < 2) {
+        return 2;
+    }
+    // Bit of the first odd number > x; gaps below 2^36 are a few words at most
+    const std::uint64_t first = (x + 1) / 2;
+    const std::uint64_t words = static_cast<const Header*>(base_)->words;
+    std::uint64_t w = first / 64;
+    std::uint64_t word = w < words ? bits_[w] & (~std::uint64_t(0) << (first % 64)) : 0;
+    while (word == 0 && ++w < words) {
+        word = bits_[w];
+    }
+    if (word == 0) {
+        throw std::out_of_range("prime table: next prime lies beyond the table limit");
+    }
+    return 2 * (w * 64 + static_cast<std::uint64_t>(__builtin_ctzll(word))) + 1;
+}
+
+void PrimeTable::count_batch(const std::int64_t* lo, const std::int64_t* hi, std::int64_t* out,
+                             std::size_t n) const {
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::int64_t first = std::max<std::int64_t>(lo[i], 0);
+        out[i] = hi[i] < first ? 0
+                               : static_cast<std::int64_t>(count(static_cast<std::uint64_t>(first),
+                                                                 static_cast<std::uint64_t>(hi[i])));
+    }
+}
+
+void PrimeTable::nth_batch(const std::int64_t* k, std::int64_t* out, std::size_t n) const {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (k[i] < 1) {
+            throw std::out_of_range("prime table: no such prime within the table limit");
+        }
+        out[i] = static_cast<std::int64_t>(nth(static_cast<std::uint64_t>(k[i])));
+    }
+}
+
+void PrimeTable::next_prime_batch(const std::int64_t* x, std::int64_t* out, std::size_t n) const {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = x[i] < 0 ? 2 : static_cast<std::int64_t>(next_prime(static_cast<std::uint64_t>(x[i])));
+    }
+}
+
+void PrimeTable::save(const std::string& path) const {
+    // Unique per process so concurrent builders never share a temporary
+#if defined(CPP_PRIME_TABLE_MMAP)
+    const std::string temp = path + ".tmp." + std::to_string(getpid());
+#else
+    const std::string temp = path + ".tmp";
+#endif
+    std::FILE* file = std::fopen(temp.c_str(), "wb");
+    if (!file) {
+        fail(temp, "cannot create");
+    }
+    bool ok = std::fwrite(base_, 1, bytes_, file) == bytes_;
+    ok = std::fflush(file) == 0 && ok;
+#if defined(CPP_PRIME_TABLE_MMAP)
+    ok = fsync(fileno(file)) == 0 && ok;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::remove(temp.c_str());
+        fail(temp, "write error");
+    }
+    if (std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        fail(path, "cannot replace");
+    }
+}
+
+std::shared_ptr<const PrimeTable> open_or_build(const std::string& path, std::uint64_t limit,
+                                                unsigned threads, bool verify) {
+    try {
+        std::shared_ptr<const PrimeTable> table = PrimeTable::open(path, verify);
+        if (table->limit() >= limit) {
+            return table;
+        }
+    } catch (const std::runtime_error&) {
+        if (limit == 0) {
+            throw;
+        }
+    }
+    PrimeTable::build(limit, threads)->save(path);
+    // Map what was just written, so this process shares pages with later ones
+    return PrimeTable::open(path, false);
+}
+
+std::shared_ptr<const PrimeTable> active_table() {
+    std::lock_guard<std::mutex> lock(g_active_mutex);
+    return g_active;
+}
+
+void set_active_table(std::shared_ptr<const PrimeTable> table) {
+    std::shared_ptr<const PrimeTable> previous;
+    {
+        std::lock_guard<std::mutex> lock(g_active_mutex);
+        previous = std::exchange(g_active, std::move(table));
+    }
+    // previous is released here, outside the lock, in case it was the last owner
+}
+
+} // namespace sieve
+} // namespace cpp_functions
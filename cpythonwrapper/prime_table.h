@@ -0,0 +1,169 @@
+#ifndef PRIME_TABLE_H
+#define PRIME_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "small_tables.h"
+
+/**
+ * Bit-packed prime table with block-level running counts.
+ * Bit i of the bitmap is set when 2i + 1 is prime and every 512-bit block
+ * stores how many odd primes precede it, so pi(n) is one block count plus
+ * at most eight popcounts and primality is a single bit test. A table is
+ * built once, written to a versioned, checksummed file, and mapped
+ * read-only by later processes: they start without sieving, and every
+ * process mapping the same file shares its pages through the page cache.
+ */
+
+namespace cpp_functions {
+namespace sieve {
+
+/** Largest limit a table can be built for (a 4 GiB bitmap). */
+constexpr std::uint64_t kPrimeTableMaxLimit = std::uint64_t(1) << 36;
+
+/** Bitmap words covered by one running count (one cache line). */
+constexpr std::size_t kPrimeTableBlockWords = 8;
+
+/** Version written to and required from table files. */
+constexpr std::uint32_t kPrimeTableVersion = 1;
+
+class PrimeTable {
+public:
+    /**
+     * Sieve [0, limit] on up to threads threads of the shared pool
+     * (0 = the whole pool). Throws std::invalid_argument past
+     * kPrimeTableMaxLimit.
+     */
+    static std::shared_ptr<const PrimeTable> build(std::uint64_t limit, unsigned threads = 0);
+
+    /**
+     * Map a file written by save() read-only (read into memory where mmap
+     * is unavailable). Throws std::runtime_error when it cannot be read or
+     * is truncated, of another version or byte order, or, with verify,
+     * fails its checksum.
+     */
+    static std::shared_ptr<const PrimeTable> open(const std::string& path, bool verify = true);
+
+    /**
+     * Write the table to path through a temporary file renamed over it, so
+     * processes that map the old file keep a consistent view. Throws
+     * std::runtime_error on I/O errors.
+     */
+    void save(const std::string& path) const;
+
+    ~PrimeTable();
+    PrimeTable(const PrimeTable&) = delete;
+    PrimeTable& operator=(const PrimeTable&) = delete;
+
+    /** Largest value the table answers for. */
+    std::uint64_t limit() const { return limit_; }
+
+    /** pi(limit). */
+    std::uint64_t total() const { return total_; }
+
+    /** True when the table is a mapping of its file rather than private memory. */
+    bool mapped() const { return mapped_; }
+
+    /** Size of the table, equal to the size of its file. */
+    std::size_t bytes() const { return bytes_; }
+
+    /** Whether n is prime, for n <= limit(). */
+    bool is_prime(std::uint64_t n) const {
+        if (n < 3) {
+            return n == 2;
+        }
+        return n % 2 == 1 && ((bits_[n / 128] >> (n / 2 % 64)) & 1) != 0;
+    }
+
+    /** Primes <= n, for n <= limit(). */
+    std::uint64_t count(std::uint64_t n) const {
+        if (n < 2) {
+            return 0;
+        }
+        const std::uint64_t i = (n - 1) / 2;
+        const std::uint64_t w = i / 64;
+        std::uint64_t total = 1 + counts_[w / kPrimeTableBlockWords];
+        for (std::uint64_t k = w - w % kPrimeTableBlockWords; k < w; ++k) {
+            total += static_cast<std::uint64_t>(__builtin_popcountll(bits_[k]));
+        }
+        const std::uint64_t mask = (std::uint64_t(2) << (i % 64)) - 1;
+        return total + static_cast<std::uint64_t>(__builtin_popcountll(bits_[w] & mask));
+    }
+
+    /** Primes in [lo, hi]: 0 when hi < lo. Throws std::out_of_range if hi > limit(). */
+    std::uint64_t count(std::uint64_t lo, std::uint64_t hi) const;
+
+    /**
+     * The k-th prime (nth(1) == 2): a binary search over the block counts,
+     * then a scan of one block. Throws std::out_of_range unless
+     * 1 <= k <= total().
+     */
+    std::uint64_t nth(std::uint64_t k) const;
+
+    /**
+     * Smallest prime > x, found by scanning the bitmap from x on. Throws
+     * std::out_of_range when it lies beyond limit().
+     */
+    std::uint64_t next_prime(std::uint64_t x) const;
+
+    /**
+     * Batch queries over int64 arrays, as used from NumPy: out[i] is
+     * count(max(lo[i], 0), hi[i]) (0 when hi[i] < lo[i]), nth(k[i]) and
+     * next_prime(x[i]) (2 for negative x[i]). Errors as for the scalar forms.
+     */
+    void count_batch(const std::int64_t* lo, const std::int64_t* hi, std::int64_t* out, std::size_t n) const;
+    void nth_batch(const std::int64_t* k, std::int64_t* out, std::size_t n) const;
+    void next_prime_batch(const std::int64_t* x, std::int64_t* out, std::size_t n) const;
+
+    /** Primes in [lo, hi], hi <= limit(), in increasing order. */
+    template <typename F>
+    void for_each_prime(std::uint64_t lo, std::uint64_t hi, F&& f) const {
+        if (lo <= 2 && hi >= 2) {
+            f(std::uint64_t(2));
+        }
+        const std::uint64_t first = lo < 3 ? 1 : lo / 2;
+        const std::uint64_t last = hi < 3 ? 0 : (hi - 1) / 2 + 1;
+        small::for_each_odd_bit(bits_, first, last, f);
+    }
+
+private:
+    PrimeTable(void* base, std::size_t bytes, bool mapped);
+
+    /** Own base (freed or unmapped even if this throws). */
+    static std::shared_ptr<const PrimeTable> adopt(void* base, std::size_t bytes, bool mapped);
+
+    void* base_;    // file image: header, bitmap, running counts
+    std::size_t bytes_;
+    bool mapped_;
+    const std::uint64_t* bits_ = nullptr;
+    const std::uint64_t* counts_ = nullptr;
+    std::uint64_t limit_ = 0;
+    std::uint64_t total_ = 0;
+};
+
+/**
+ * Open the table at path. When that fails or the file stops short of
+ * limit, and limit is nonzero, build a table to limit on threads threads,
+ * save it to path and map the saved file instead; limit == 0 only opens.
+ */
+std::shared_ptr<const PrimeTable> open_or_build(const std::string& path, std::uint64_t limit,
+                                                unsigned threads = 0, bool verify = true);
+
+/**
+ * Table the prime kernels answer from when it covers their input; null
+ * until set_active_table() installs one.
+ */
+std::shared_ptr<const PrimeTable> active_table();
+
+/**
+ * Install table process-wide, or drop it with nullptr. Calls already
+ * holding the previous table finish on it; it is freed or unmapped after.
+ */
+void set_active_table(std::shared_ptr<const PrimeTable> table);
+
+} // namespace sieve
+} // namespace cpp_functions
+
+#endif // PRIME_TABLE_H
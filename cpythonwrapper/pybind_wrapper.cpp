@@ -1,95 +1,1441 @@
-#include <pybind11/pybind11.h>
-#include <pybind11/stl.h>
-#include <pybind11/numpy.h>
-#include <chrono>
-#include "cpp_functions.h"
-
-/**
- * Python bindings for C++ functions using pybind11.
- * This file creates the bridge between Python and C++ implementations.
- */
-
-namespace py = pybind11;
-
-PYBIND11_MODULE(cpp_accelerated, m) {
-    m.doc() = "C++ accelerated functions for Python - Performance comparison module";
-    
-    // Basic functions that mirror Python implementation
-    m.def("sum_of_squares", &cpp_functions::sum_of_squares, 
-          "Calculate the sum of squares from 1 to n (C++ implementation)",
-          py::arg("n"));
-    
-    m.def("fibonacci_recursive", &cpp_functions::fibonacci_recursive,
-          "Calculate the nth Fibonacci number using recursive approach (C++ implementation)", 
-          py::arg("n"));
-    
-    m.def("prime_count", &cpp_functions::prime_count,
-          "Count the number of prime numbers up to the given limit (C++ implementation)",
-          py::arg("limit"));
-    
-    m.def("matrix_multiplication", &cpp_functions::matrix_multiplication,
-          "Perform matrix multiplication of two size x size matrices (C++ implementation)",
-          py::arg("size"));
-    
-    // Optimized versions that leverage C++ capabilities
-    m.def("sum_of_squares_optimized", &cpp_functions::sum_of_squares_optimized,
-          "Calculate sum of squares using mathematical formula (C++ optimized)",
-          py::arg("n"));
-    
-    m.def("prime_count_optimized", &cpp_functions::prime_count_optimized,
-          "Count primes using Sieve of Eratosthenes (C++ optimized)",
-          py::arg("limit"));
-    
-    m.def("fibonacci_memoized", &cpp_functions::fibonacci_memoized,
-          "Calculate Fibonacci with memoization (C++ optimized)",
-          py::arg("n"));
-    
-    // Wrapper functions for easier benchmarking
-    m.def("benchmark_sum_of_squares", [](int n, int iterations) {
-        auto start = std::chrono::high_resolution_clock::now();
-        long long result = 0;
-        for (int i = 0; i < iterations; ++i) {
-            result = cpp_functions::sum_of_squares(n);
-        }
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-        double avg_time = duration.count() / (1e9 * iterations);
-        return py::make_tuple(result, avg_time);
-    }, "Benchmark sum_of_squares function", py::arg("n"), py::arg("iterations") = 1);
-    
-    m.def("benchmark_prime_count", [](int limit, int iterations) {
-        auto start = std::chrono::high_resolution_clock::now();
-        int result = 0;
-        for (int i = 0; i < iterations; ++i) {
-            result = cpp_functions::prime_count(limit);
-        }
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-        double avg_time = duration.count() / (1e9 * iterations);
-        return py::make_tuple(result, avg_time);
-    }, "Benchmark prime_count function", py::arg("limit"), py::arg("iterations") = 1);
-    
-    m.def("benchmark_fibonacci", [](int n, int iterations) {
-        auto start = std::chrono::high_resolution_clock::now();
-        long long result = 0;
-        for (int i = 0; i < iterations; ++i) {
-            result = cpp_functions::fibonacci_recursive(n);
-        }
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-        double avg_time = duration.count() / (1e9 * iterations);
-        return py::make_tuple(result, avg_time);
-    }, "Benchmark fibonacci_recursive function", py::arg("n"), py::arg("iterations") = 1);
-    
-    m.def("benchmark_matrix_mult", [](int size, int iterations) {
-        auto start = std::chrono::high_resolution_clock::now();
-        std::vector<std::vector<int>> result;
-        for (int i = 0; i < iterations; ++i) {
-            result = cpp_functions::matrix_multiplication(size);
-        }
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-        double avg_time = duration.count() / (1e9 * iterations);
-        return py::make_tuple(result[0][0], avg_time); // Return first element as sample
-    }, "Benchmark matrix_multiplication function", py::arg("size"), py::arg("iterations") = 1);
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "bench.h"
+#include "cancellation.h"
+#include "cpp_functions.h"
+#include "cpu_features.h"
+#include "gemm.h"
+#include "metrics.h"
+#include "perf_counters.h"
+#include "prime_table.h"
+#include "scratch.h"
+#include "segmented_sieve.h"
+#include "thread_pool.h"
+#include "wheel_sieve.h"
+
+/**
+ * Python bindings for C++ functions using pybind11.
+ * This file creates the bridge between Python and C++ implementations.
+ */
+
+namespace py = pybind11;
+
+namespace {
+
+/**
+ * Hand a vector to NumPy without copying: the array views the vector's
+ * buffer and a capsule frees the vector when the array is collected.
+ */
+template <typename T>
+py::array_t<T> to_numpy(std::vector<T>&& values) {
+    auto* owned = new std::vector<T>(std::move(values));
+    py::capsule free_when_done(owned, [](void* p) {
+        delete static_cast<std::vector<T>*>(p);
+    });
+    return py::array_t<T>(owned->size(), owned->data(), free_when_done);
+}
+
+/**
+ * Map the backend= argument of prime_count_optimized to a SieveBackend.
+ */
+cpp_functions::SieveBackend parse_backend(const std::string& name) {
+    if (name == "segmented") {
+        return cpp_functions::SieveBackend::segmented;
+    }
+    if (name == "wheel30") {
+        return cpp_functions::SieveBackend::wheel30;
+    }
+    throw py::value_error("backend must be 'segmented' or 'wheel30', got '" + name + "'");
+}
+
+/**
+ * Map an accumulator= argument to an Accumulator.
+ */
+cpp_functions::Accumulator parse_accumulator(const std::string& name) {
+    if (name == "int32") {
+        return cpp_functions::Accumulator::int32;
+    }
+    if (name == "int64") {
+        return cpp_functions::Accumulator::int64;
+    }
+    if (name == "int128") {
+        return cpp_functions::Accumulator::int128;
+    }
+    if (name == "checked") {
+        return cpp_functions::Accumulator::checked;
+    }
+    throw py::value_error("accumulator must be 'int32', 'int64', 'int128' or 'checked', got '" + name + "'");
+}
+
+/**
+ * Map the algorithm= argument of matmul to a GemmAlgorithm.
+ */
+cpp_functions::GemmAlgorithm parse_algorithm(const std::string& name) {
+    if (name == "classical") {
+        return cpp_functions::GemmAlgorithm::classical;
+    }
+    if (name == "strassen") {
+        return cpp_functions::GemmAlgorithm::strassen;
+    }
+    throw py::value_error("algorithm must be 'classical' or 'strassen', got '" + name + "'");
+}
+
+/**
+ * Hand a Matrix to NumPy as a 2-D array that shares its buffer.
+ */
+template <typename T>
+py::array_t<T> to_numpy(cpp_functions::Matrix<T>&& matrix) {
+    auto* owned = new cpp_functions::Matrix<T>(std::move(matrix));
+    py::capsule free_when_done(owned, [](void* p) {
+        delete static_cast<cpp_functions::Matrix<T>*>(p);
+    });
+    std::vector<py::ssize_t> shape = {static_cast<py::ssize_t>(owned->rows()),
+                                      static_cast<py::ssize_t>(owned->cols())};
+    std::vector<py::ssize_t> strides = {static_cast<py::ssize_t>(owned->cols() * sizeof(T)),
+                                        static_cast<py::ssize_t>(sizeof(T))};
+    return py::array_t<T>(shape, strides, owned->data(), free_when_done);
+}
+
+/**
+ * Primes in [lo, hi] as a uint32 array when they fit, uint64 otherwise.
+ */
+py::array primes_array(long long lo, long long hi) {
+    if (hi < 2 || hi < lo) {
+        return py::array_t<std::uint32_t>(0);
+    }
+    std::uint64_t first = static_cast<std::uint64_t>(std::max(lo, 0LL));
+    std::uint64_t last = static_cast<std::uint64_t>(hi);
+    if (last <= UINT32_MAX) {
+        std::vector<std::uint32_t> primes;
+        {
+            py::gil_scoped_release release;
+            primes = cpp_functions::sieve::collect_primes<std::uint32_t>(first, last);
+        }
+        return to_numpy(std::move(primes));
+    }
+    std::vector<std::uint64_t> primes;
+    {
+        py::gil_scoped_release release;
+        primes = cpp_functions::sieve::collect_primes<std::uint64_t>(first, last);
+    }
+    return to_numpy(std::move(primes));
+}
+
+/**
+ * Build a Python int from little-endian base 2^32 limbs in one step.
+ * CPython parses power-of-two bases in linear time, so the number is
+ * formatted as hex once instead of being assembled limb by limb.
+ */
+py::int_ limbs_to_int(const std::vector<std::uint32_t>& limbs) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(limbs.size() * 8 + 1);
+    for (std::size_t i = limbs.size(); i-- > 0;) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            hex.push_back(digits[(limbs[i] >> shift) & 0xF]);
+        }
+    }
+    if (hex.empty()) {
+        hex = "0";
+    }
+    PyObject* value = PyLong_FromString(hex.c_str(), nullptr, 16);
+    if (value == nullptr) {
+        throw py::error_already_set();
+    }
+    return py::reinterpret_steal<py::int_>(value);
+}
+
+/**
+ * Produce the next chunk of a PrimeStream as a NumPy array.
+ * Raises StopIteration once the range is exhausted.
+ */
+template <typename T>
+py::array next_chunk(cpp_functions::sieve::PrimeStream& stream) {
+    std::vector<T> chunk(stream.chunk_size());
+    std::size_t n = stream.fill(chunk.data());
+    if (n == 0) {
+        throw py::stop_iteration();
+    }
+    chunk.resize(n);
+    return to_numpy(std::move(chunk));
+}
+
+/**
+ * Strided view of a 2-D NumPy array with element type T. Arrays whose byte
+ * strides are not a multiple of sizeof(T) are copied to C order first.
+ */
+template <typename T>
+cpp_functions::MatrixView<T> matrix_view(py::array& array, const char* name) {
+    using Element = typename std::remove_const<T>::type;
+    if (array.ndim() != 2) {
+        throw py::value_error(std::string(name) + " must be a 2-D array");
+    }
+    const py::ssize_t item = static_cast<py::ssize_t>(sizeof(T));
+    if (array.strides(0) % item != 0 || array.strides(1) % item != 0) {
+        array = py::array_t<Element, py::array::c_style | py::array::forcecast>::ensure(array);
+    }
+    return cpp_functions::MatrixView<T>{
+        static_cast<T*>(const_cast<void*>(array.data())),
+        static_cast<std::size_t>(array.shape(0)), static_cast<std::size_t>(array.shape(1)),
+        array.strides(0) / item, array.strides(1) / item};
+}
+
+/**
+ * Byte range [first, last) touched by a view, for overlap checks.
+ */
+template <typename T>
+std::pair<const char*, const char*> byte_extent(const cpp_functions::MatrixView<T>& v) {
+    if (v.rows == 0 || v.cols == 0) {
+        return {nullptr, nullptr};
+    }
+    const char* base = reinterpret_cast<const char*>(v.data);
+    std::ptrdiff_t lo = 0;
+    std::ptrdiff_t hi = 0;
+    for (std::ptrdiff_t step : {static_cast<std::ptrdiff_t>(v.rows - 1) * v.row_stride,
+                                static_cast<std::ptrdiff_t>(v.cols - 1) * v.col_stride}) {
+        (step < 0 ? lo : hi) += step;
+    }
+    return {base + lo * static_cast<std::ptrdiff_t>(sizeof(T)),
+            base + (hi + 1) * static_cast<std::ptrdiff_t>(sizeof(T))};
+}
+
+template <typename T, typename U>
+bool may_overlap(const cpp_functions::MatrixView<T>& x, const cpp_functions::MatrixView<U>& y) {
+    auto ex = byte_extent(x);
+    auto ey = byte_extent(y);
+    return ex.first != nullptr && ey.first != nullptr && ex.first < ey.second && ey.first < ex.second;
+}
+
+/**
+ * How matmul should multiply: algorithm, Strassen cutoff and thread count.
+ */
+struct MatmulOptions {
+    cpp_functions::GemmAlgorithm algorithm;
+    std::size_t cutoff;
+    unsigned threads;
+};
+
+/**
+ * Multiply with the algorithm chosen in options.
+ */
+template <typename T>
+void run_gemm(cpp_functions::MatrixView<const T> a, cpp_functions::MatrixView<const T> b,
+              cpp_functions::MatrixView<T> c, const MatmulOptions& options) {
+    if (options.algorithm == cpp_functions::GemmAlgorithm::strassen) {
+        cpp_functions::gemm_strassen(a, b, c, options.cutoff, options.threads);
+    } else {
+        cpp_functions::gemm(a, b, c, options.threads);
+    }
+}
+
+/**
+ * A validated matmul call. prepare_matmul checks the operands with the GIL
+ * held; run() multiplies without it and finish() hands back the product.
+ */
+struct MatmulJob {
+    virtual ~MatmulJob() = default;
+    virtual void run() = 0;
+    virtual py::object finish() = 0;
+};
+
+/**
+ * matmul for one element type. Inputs are read through their strides; the
+ * product goes to out when given, otherwise to a new C-ordered array.
+ */
+template <typename T>
+class TypedMatmulJob : public MatmulJob {
+public:
+    TypedMatmulJob(py::array a, py::array b, py::object out, const MatmulOptions& options)
+        : a_(std::move(a)), b_(std::move(b)), options_(options) {
+        if (!py::array_t<T>::check_(b_)) {
+            throw py::type_error("matmul: a and b must have the same dtype");
+        }
+        a_in_ = matrix_view<const T>(a_, "a");
+        b_in_ = matrix_view<const T>(b_, "b");
+        if (a_in_.cols != b_in_.rows) {
+            throw py::value_error("matmul: inner dimensions do not match");
+        }
+        if (out.is_none()) {
+            result_ = cpp_functions::Matrix<T>(a_in_.rows, b_in_.cols);
+            c_view_ = cpp_functions::view(result_);
+            return;
+        }
+
+        if (!py::array_t<T>::check_(out)) {
+            throw py::type_error("out must be an array with the same dtype as a and b");
+        }
+        out_ = py::reinterpret_borrow<py::array>(out);
+        if (!out_.writeable()) {
+            throw py::value_error("out must be writeable");
+        }
+        c_view_ = matrix_view<T>(out_, "out");
+        if (out_.ptr() != out.ptr()) {
+            throw py::value_error("out strides must be a multiple of the item size");
+        }
+        if (c_view_.rows != a_in_.rows || c_view_.cols != b_in_.cols) {
+            throw py::value_error("out has the wrong shape");
+        }
+        has_out_ = true;
+    }
+
+    void run() override {
+        if (has_out_ && (may_overlap(c_view_, a_in_) || may_overlap(c_view_, b_in_))) {
+            // Writing in place would clobber inputs still being read
+            cpp_functions::Matrix<T> scratch(c_view_.rows, c_view_.cols);
+            run_gemm(a_in_, b_in_, cpp_functions::view(scratch), options_);
+            for (std::size_t i = 0; i < c_view_.rows; ++i) {
+                for (std::size_t j = 0; j < c_view_.cols; ++j) {
+                    c_view_(i, j) = scratch(i, j);
+                }
+            }
+        } else {
+            run_gemm(a_in_, b_in_, c_view_, options_);
+        }
+    }
+
+    py::object finish() override {
+        if (has_out_) {
+            return out_;
+        }
+        return to_numpy(std::move(result_));
+    }
+
+private:
+    py::array a_, b_, out_;  // own the operands (or their C-ordered copies)
+    cpp_functions::MatrixView<const T> a_in_;
+    cpp_functions::MatrixView<const T> b_in_;
+    cpp_functions::MatrixView<T> c_view_;
+    cpp_functions::Matrix<T> result_;
+    MatmulOptions options_;
+    bool has_out_ = false;
+};
+
+/**
+ * Validate matmul arguments and pick the job for the dtype shared by a and b.
+ */
+std::unique_ptr<MatmulJob> prepare_matmul(py::array a, py::array b, py::object out, int threads,
+                                          const std::string& algorithm, long long strassen_cutoff) {
+    if (threads < 0) {
+        throw py::value_error("threads must be non-negative");
+    }
+    if (strassen_cutoff < 1) {
+        throw py::value_error("strassen_cutoff must be positive");
+    }
+    const MatmulOptions options{parse_algorithm(algorithm),
+                                static_cast<std::size_t>(strassen_cutoff),
+                                static_cast<unsigned>(threads)};
+    if (py::array_t<std::int32_t>::check_(a)) {
+        return std::unique_ptr<MatmulJob>(new TypedMatmulJob<std::int32_t>(a, b, out, options));
+    }
+    if (py::array_t<std::int64_t>::check_(a)) {
+        return std::unique_ptr<MatmulJob>(new TypedMatmulJob<std::int64_t>(a, b, out, options));
+    }
+    if (py::array_t<float>::check_(a)) {
+        return std::unique_ptr<MatmulJob>(new TypedMatmulJob<float>(a, b, out, options));
+    }
+    if (py::array_t<double>::check_(a)) {
+        return std::unique_ptr<MatmulJob>(new TypedMatmulJob<double>(a, b, out, options));
+    }
+    throw py::type_error("matmul supports int32, int64, float32 and float64 arrays");
+}
+
+using TokenPtr = std::shared_ptr<cpp_functions::CancellationToken>;
+
+/** How often a blocking call looks for pending signals such as Ctrl-C. */
+constexpr std::chrono::milliseconds kSignalPollInterval(50);
+
+/** CancelledError, created when the module is initialised. */
+PyObject* g_cancelled_error = nullptr;
+
+/**
+ * Python exception type for a Cancelled: TimeoutError for an expired
+ * deadline, CancelledError otherwise.
+ */
+PyObject* cancelled_type(const cpp_functions::Cancelled& error) {
+    if (error.reason() == cpp_functions::Cancelled::Reason::deadline) {
+        return PyExc_TimeoutError;
+    }
+    return g_cancelled_error;
+}
+
+/**
+ * Apply a timeout= argument (seconds, or None for no limit) to token.
+ */
+void apply_timeout(cpp_functions::CancellationToken& token, const py::object& timeout) {
+    if (timeout.is_none()) {
+        return;
+    }
+    const double seconds = timeout.cast<double>();
+    if (!(seconds >= 0)) {
+        throw py::value_error("timeout must be a non-negative number of seconds or None");
+    }
+    // Limits beyond a few decades are as good as none and would overflow the clock
+    if (seconds < 1e9) {
+        using Clock = cpp_functions::CancellationToken::Clock;
+        token.set_deadline(Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                              std::chrono::duration<double>(seconds)));
+    }
+}
+
+/**
+ * Run compute with the GIL released under a token that trips on timeout,
+ * on cancel (when given) or when a signal handler raises, e.g. Ctrl-C's
+ * KeyboardInterrupt. The calling thread re-takes the GIL every
+ * kSignalPollInterval to run pending handlers; a handler's exception is
+ * re-raised as is.
+ */
+void run_interruptible(const py::object& timeout, const TokenPtr& cancel,
+                       const std::function<void()>& compute) {
+    cpp_functions::CancellationToken token(cancel.get());
+    apply_timeout(token, timeout);
+    std::unique_ptr<py::error_already_set> signal_error;
+    token.set_poll([&token, &signal_error] {
+        py::gil_scoped_acquire gil;
+        if (PyErr_CheckSignals() != 0) {
+            signal_error.reset(new py::error_already_set());
+            token.cancel(cpp_functions::Cancelled::Reason::interrupted);
+        }
+    }, kSignalPollInterval);
+
+    try {
+        py::gil_scoped_release release;
+        cpp_functions::CancellationScope scope(&token);
+        compute();
+    } catch (const cpp_functions::Cancelled&) {
+        if (signal_error) {
+            throw *signal_error;
+        }
+        throw;
+    }
+}
+
+/**
+ * run_interruptible for a function returning a value.
+ */
+template <typename Fn>
+auto call_interruptible(const py::object& timeout, const TokenPtr& cancel, Fn fn) -> decltype(fn()) {
+    decltype(fn()) result{};
+    run_interruptible(timeout, cancel, [&result, &fn] { result = fn(); });
+    return result;
+}
+
+/**
+ * Token for one *_async call: a child of cancel (when given) with the
+ * call's timeout counted from submission.
+ */
+TokenPtr async_token(const py::object& timeout, const TokenPtr& cancel) {
+    TokenPtr token = std::make_shared<cpp_functions::CancellationToken>(cancel.get());
+    apply_timeout(*token, timeout);
+    return token;
+}
+
+py::object matmul(py::array a, py::array b, py::object out, int threads,
+                  const std::string& algorithm, long long strassen_cutoff,
+                  py::object timeout, TokenPtr cancel) {
+    std::unique_ptr<MatmulJob> job = prepare_matmul(a, b, out, threads, algorithm, strassen_cutoff);
+    run_interruptible(timeout, cancel, [&job] { job->run(); });
+    return job->finish();
+}
+
+/**
+ * Python exception object equivalent to a C++ exception, following
+ * pybind11's own translation of the standard exception types.
+ */
+py::object python_exception(std::exception_ptr error) {
+    auto make = [](PyObject* type, const char* message) {
+        return py::reinterpret_borrow<py::object>(type)(message);
+    };
+    try {
+        std::rethrow_exception(error);
+    } catch (py::error_already_set& e) {
+        return e.value();
+    } catch (const py::builtin_exception& e) {
+        e.set_error();
+        return py::error_already_set().value();
+    } catch (const cpp_functions::Cancelled& e) {
+        return make(cancelled_type(e), e.what());
+    } catch (const std::invalid_argument& e) {
+        return make(PyExc_ValueError, e.what());
+    } catch (const std::domain_error& e) {
+        return make(PyExc_ValueError, e.what());
+    } catch (const std::length_error& e) {
+        return make(PyExc_ValueError, e.what());
+    } catch (const std::out_of_range& e) {
+        return make(PyExc_IndexError, e.what());
+    } catch (const std::overflow_error& e) {
+        return make(PyExc_OverflowError, e.what());
+    } catch (const std::bad_alloc&) {
+        return make(PyExc_MemoryError, "std::bad_alloc");
+    } catch (const std::exception& e) {
+        return make(PyExc_RuntimeError, e.what());
+    } catch (...) {
+        return make(PyExc_RuntimeError, "unknown C++ exception");
+    }
+}
+
+void resolve_future(py::object future, py::object value) {
+    if (!future.attr("done")().cast<bool>()) {
+        future.attr("set_result")(value);
+    }
+}
+
+void reject_future(py::object future, py::object exception) {
+    if (!future.attr("done")().cast<bool>()) {
+        future.attr("set_exception")(exception);
+    }
+}
+
+/**
+ * One *_async call in flight. compute runs on a pool worker without the
+ * GIL under token; finish converts its result once the GIL is reacquired.
+ * The Python objects are only touched, and the call only deleted, with the
+ * GIL held. parent keeps the caller's token alive while token refers to it.
+ */
+struct AsyncCall {
+    py::object loop;
+    py::object future;
+    std::function<void()> compute;
+    std::function<py::object()> finish;
+    TokenPtr token;
+    TokenPtr parent;
+};
+
+void complete_async(AsyncCall* call) {
+    std::exception_ptr error;
+    try {
+        cpp_functions::CancellationScope scope(call->token.get());
+        call->compute();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    py::gil_scoped_acquire gil;
+    py::object value;
+    if (!error) {
+        try {
+            value = call->finish();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    try {
+        // The future belongs to the loop's thread; hand the outcome over there
+        if (error) {
+            call->loop.attr("call_soon_threadsafe")(py::cpp_function(&reject_future), call->future,
+                                                    python_exception(error));
+        } else {
+            call->loop.attr("call_soon_threadsafe")(py::cpp_function(&resolve_future), call->future,
+                                                    value);
+        }
+    } catch (py::error_already_set&) {
+        // The loop was closed in the meantime; nobody is waiting any more
+    }
+    delete call;
+}
+
+/**
+ * Start compute on the shared pool and return an asyncio future of the
+ * running loop that finish() resolves. Must be called from a coroutine or
+ * callback running in that loop. Cancelling the future stops compute at
+ * its next cancellation point, as do timeout and cancel.
+ */
+py::object submit_async(std::function<void()> compute, std::function<py::object()> finish,
+                        const py::object& timeout, const TokenPtr& cancel) {
+    py::object loop = py::module_::import("asyncio").attr("get_running_loop")();
+    TokenPtr token = async_token(timeout, cancel);
+    std::unique_ptr<AsyncCall> call(new AsyncCall{loop, loop.attr("create_future")(),
+                                                  std::move(compute), std::move(finish),
+                                                  token, cancel});
+    py::object future = call->future;
+    future.attr("add_done_callback")(py::cpp_function([token](py::object done) {
+        if (done.attr("cancelled")().cast<bool>()) {
+            token->cancel();
+        }
+    }));
+    AsyncCall* raw = call.get();
+    cpp_functions::submit([raw] { complete_async(raw); });
+    call.release();  // complete_async owns it from here
+    return future;
+}
+
+/**
+ * submit_async for a function returning a value pybind11 can convert.
+ */
+template <typename Fn>
+py::object async_value(Fn fn, const py::object& timeout, const TokenPtr& cancel) {
+    using Result = decltype(fn());
+    auto result = std::make_shared<Result>();
+    return submit_async([fn, result] { *result = fn(); },
+                        [result] { return py::cast(*result); }, timeout, cancel);
+}
+
+/**
+ * bench() result as a dict, times in seconds per call.
+ */
+py::dict stats_to_dict(const std::string& name, const std::vector<long long>& args,
+                       const cpp_functions::bench::Stats& stats) {
+    py::dict result;
+    result["name"] = name;
+    result["args"] = py::tuple(py::cast(args));
+    result["samples"] = stats.samples;
+    result["iterations"] = stats.iterations;
+    result["min"] = stats.min;
+    result["median"] = stats.median;
+    result["mean"] = stats.mean;
+    result["p95"] = stats.p95;
+    result["p99"] = stats.p99;
+    result["max"] = stats.max;
+    result["stddev"] = stats.stddev;
+    result["cv"] = stats.cv;
+    result["items_per_second"] = stats.items_per_second;
+    result["gflops"] = stats.gflops;
+    return result;
+}
+
+/**
+ * perf_counters() result: per-call counts of the supported events plus the
+ * usual ratios when both of their events were counted.
+ */
+py::dict reading_to_dict(const std::string& name, const std::vector<long long>& args,
+                         const cpp_functions::perf::Reading& reading) {
+    using cpp_functions::perf::Event;
+    py::dict result;
+    result["name"] = name;
+    result["args"] = py::tuple(py::cast(args));
+    result["available"] = reading.has(Event::cycles) || reading.has(Event::instructions);
+    if (!reading.error.empty()) {
+        result["error"] = reading.error;
+    }
+    result["calls"] = reading.calls;
+    result["seconds"] = reading.seconds;
+    for (std::size_t i = 0; i < cpp_functions::perf::kEventCount; ++i) {
+        if (reading.supported[i]) {
+            result[cpp_functions::perf::event_name(static_cast<Event>(i))] = reading.values[i];
+        }
+    }
+    auto ratio = [&](const char* key, Event numerator, Event denominator) {
+        if (reading.has(numerator) && reading.has(denominator) && reading.value(denominator) > 0) {
+            result[key] = reading.value(numerator) / reading.value(denominator);
+        }
+    };
+    ratio("ipc", Event::instructions, Event::cycles);
+    ratio("cache_miss_rate", Event::cache_misses, Event::cache_references);
+    ratio("branch_miss_rate", Event::branch_misses, Event::branch_instructions);
+    return result;
+}
+
+/**
+ * Mean seconds per call of a one-argument kernel over iterations
+ * unbatched samples, for the benchmark_* helpers.
+ */
+double legacy_benchmark(const char* name, long long arg, int iterations) {
+    cpp_functions::bench::Config config;
+    config.repetitions = static_cast<unsigned>(std::max(iterations, 1));
+    config.min_sample_time = 0;
+    py::gil_scoped_release release;
+    return cpp_functions::bench::run(name, {arg}, config).mean;
+}
+
+/** Call signature of a function pointer or a (non-generic) lambda. */
+template <typename F>
+struct signature_of : signature_of<decltype(&F::operator())> {};
+
+template <typename R, typename... Args>
+struct signature_of<R (*)(Args...)> {
+    using type = R (*)(Args...);
+};
+
+template <typename C, typename R, typename... Args>
+struct signature_of<R (C::*)(Args...) const> {
+    using type = R (*)(Args...);
+};
+
+template <typename F, typename R, typename... Args>
+auto metered(std::size_t id, F f, R (*)(Args...)) {
+    return [id, f](Args... args) -> R {
+        cpp_functions::metrics::CallTimer timer(id);
+        try {
+            return f(std::forward<Args>(args)...);
+        } catch (const py::stop_iteration&) {
+            // How __next__ ends an iteration, not a failed call
+            throw;
+        } catch (...) {
+            timer.fail();
+            throw;
+        }
+    };
+}
+
+/**
+ * f counted and timed in the metrics registry under name, for the .def of
+ * a bound class's method ("PrimeIndex.count").
+ */
+template <typename F>
+auto metered(const char* name, F f) {
+    return metered(cpp_functions::metrics::register_function(name), f, typename signature_of<F>::type());
+}
+
+/**
+ * m.def with the call counted and timed in the metrics registry under
+ * name. The wrapper has f's exact signature, so argument conversion,
+ * docs and call guards are unchanged; a call guard also covers the timer.
+ */
+template <typename F, typename... Extra>
+void def_metered(py::module_& m, const char* name, F f, const Extra&... extra) {
+    m.def(name, metered(name, f), extra...);
+}
+
+using Int64Array = py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>;
+using BatchKernel = void (*)(const std::int64_t*, std::int64_t*, std::size_t);
+
+/**
+ * Run a batch kernel over a NumPy array with the GIL released.
+ * out, when given, must be a writeable C-contiguous int64 array with as many
+ * elements as values; otherwise a new array shaped like values is returned.
+ */
+py::array_t<std::int64_t> run_batch(BatchKernel kernel, Int64Array values, py::object out) {
+    py::array_t<std::int64_t> result;
+    if (out.is_none()) {
+        result = py::array_t<std::int64_t>(values.request().shape);
+    } else {
+        if (!py::array_t<std::int64_t, py::array::c_style>::check_(out)) {
+            throw py::type_error("out must be a C-contiguous int64 array");
+        }
+        result = py::reinterpret_borrow<py::array_t<std::int64_t>>(out);
+        if (!result.writeable()) {
+            throw py::value_error("out must be writeable");
+        }
+        if (result.size() != values.size()) {
+            throw py::value_error("out must have the same number of elements as values");
+        }
+    }
+
+    const std::int64_t* in = values.data();
+    std::int64_t* dest = result.mutable_data();
+    std::size_t n = static_cast<std::size_t>(values.size());
+    {
+        py::gil_scoped_release release;
+        kernel(in, dest, n);
+    }
+    return result;
+}
+
+/**
+ * Bind name(values, out=None) for a batch kernel.
+ */
+void def_batch(py::module_& m, const char* name, BatchKernel kernel, const char* doc) {
+    def_metered(m, name, [kernel](Int64Array values, py::object out) {
+              return run_batch(kernel, std::move(values), std::move(out));
+          },
+          doc, py::arg("values"), py::arg("out") = py::none());
+}
+
+using UInt64Array = py::array_t<std::uint64_t, py::array::c_style | py::array::forcecast>;
+
+/**
+ * Apply is_prime_batch to an integer array of any shape, with the GIL
+ * released. Signed input must be non-negative; it is then read in place,
+ * since int64 and uint64 agree on those values.
+ */
+py::array_t<bool> is_prime_array(const py::array& values) {
+    const char kind = values.dtype().kind();
+    py::array input;
+    const std::uint64_t* in;
+    if (kind == 'u') {
+        UInt64Array converted = UInt64Array::ensure(values);
+        in = converted.data();
+        input = std::move(converted);
+    } else if (kind == 'i') {
+        Int64Array converted = Int64Array::ensure(values);
+        const std::int64_t* data = converted.data();
+        if (std::any_of(data, data + converted.size(), [](std::int64_t v) { return v < 0; })) {
+            throw py::value_error("values must be non-negative");
+        }
+        in = reinterpret_cast<const std::uint64_t*>(data);
+        input = std::move(converted);
+    } else {
+        throw py::type_error("values must be an integer array");
+    }
+
+    py::array_t<bool> result(values.request().shape);
+    bool* out = result.mutable_data();
+    const std::size_t n = static_cast<std::size_t>(input.size());
+    {
+        py::gil_scoped_release release;
+        cpp_functions::is_prime_batch(in, out, n);
+    }
+    return result;
+}
+
+using PrimeTablePtr = std::shared_ptr<cpp_functions::sieve::PrimeTable>;
+
+/**
+ * Holder for a table handed to Python. Tables are immutable once built and
+ * pybind11 cannot hold pointers to const, so the const is cast away here
+ * and only const methods are bound.
+ */
+PrimeTablePtr prime_index(std::shared_ptr<const cpp_functions::sieve::PrimeTable> table) {
+    return std::const_pointer_cast<cpp_functions::sieve::PrimeTable>(std::move(table));
+}
+
+/**
+ * Run a PrimeIndex batch query over an int64 array with the GIL released,
+ * returning an int64 array shaped like values.
+ */
+template <typename Query>
+py::array_t<std::int64_t> query_batch(const Int64Array& values, Query query) {
+    py::array_t<std::int64_t> result(values.request().shape);
+    const std::int64_t* in = values.data();
+    std::int64_t* out = result.mutable_data();
+    const std::size_t n = static_cast<std::size_t>(values.size());
+    {
+        py::gil_scoped_release release;
+        query(in, out, n);
+    }
+    return result;
+}
+
+/** Python view of a prime table: limit, primes, bytes and mapped. */
+py::dict prime_table_info(const cpp_functions::sieve::PrimeTable& table) {
+    py::dict info;
+    info["limit"] = table.limit();
+    info["primes"] = table.total();
+    info["bytes"] = table.bytes();
+    info["mapped"] = table.mapped();
+    return info;
+}
+
+} // namespace
+
+PYBIND11_MODULE(cpp_accelerated, m) {
+    m.doc() = "C++ accelerated functions for Python - Performance comparison module";
+    
+    // Pick the SIMD path now, so every kernel sees the same one from the first call
+    cpp_functions::simd_path();
+    
+    // Cancellation: tokens, TimeoutError for deadlines, CancelledError otherwise
+    static py::exception<cpp_functions::Cancelled> cancelled_error(m, "CancelledError", PyExc_RuntimeError);
+    g_cancelled_error = cancelled_error.ptr();
+    py::register_exception_translator([](std::exception_ptr error) {
+        try {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        } catch (const cpp_functions::Cancelled& e) {
+            PyErr_SetString(cancelled_type(e), e.what());
+        }
+    });
+    
+    py::class_<cpp_functions::CancellationToken, TokenPtr>(m, "CancellationToken",
+        "Pass as cancel= to stop a running call from another thread or coroutine; "
+        "the call raises CancelledError at its next cancellation point")
+        .def(py::init<>())
+        .def("cancel", metered("CancellationToken.cancel", [](cpp_functions::CancellationToken& token) {
+                 token.cancel();
+             }),
+             "Request cancellation of every call using this token")
+        .def_property_readonly("cancelled", &cpp_functions::CancellationToken::stop_requested,
+                               "True once cancel() has been called");
+    
+    // Basic functions that mirror Python implementation
+    def_metered(m, "sum_of_squares", [](long long n) -> py::object {
+              if (n <= cpp_functions::kSumOfSquaresMax) {
+                  return py::int_(cpp_functions::sum_of_squares(n));
+              }
+              // Past the int64 range: exact closed form as a Python int
+              return limbs_to_int(cpp_functions::sum_of_squares_exact(n));
+          },
+          "Calculate the sum of squares from 1 to n (C++ implementation). "
+          "Accepts any 64-bit n and returns the exact value as a Python int",
+          py::arg("n"));
+    
+    def_metered(m, "fibonacci_recursive",
+          [](int n, py::object timeout, TokenPtr cancel) {
+              return call_interruptible(timeout, cancel,
+                                        [n] { return cpp_functions::fibonacci_recursive(n); });
+          },
+          "Calculate the nth Fibonacci number using recursive approach (C++ implementation). "
+          "Raises TimeoutError after timeout seconds, CancelledError once cancel is cancelled; "
+          "Ctrl-C interrupts it", 
+          py::arg("n"), py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+
+    def_metered(m, "fibonacci_recursive_parallel",
+          [](int n, int threads, int cutoff, bool memoize, py::object timeout, TokenPtr cancel) {
+              return call_interruptible(timeout, cancel, [=] {
+                  return cpp_functions::fibonacci_recursive_parallel(n, threads, cutoff, memoize);
+              });
+          },
+          "fibonacci_recursive with calls fewer than cutoff levels deep forking their two "
+          "subtrees onto the shared thread pool (threads=0 uses all of it; cutoff=-1 picks "
+          "log2(threads) + 4). memoize=True shares a per-call cache of finished forked subtrees. "
+          "Returns the same value as fibonacci_recursive; timeout and cancel work as there",
+          py::arg("n"), py::arg("threads") = 0, py::arg("cutoff") = -1, py::arg("memoize") = false,
+          py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+    
+    def_metered(m, "prime_count",
+          [](int limit, py::object timeout, TokenPtr cancel) {
+              return call_interruptible(timeout, cancel,
+                                        [limit] { return cpp_functions::prime_count(limit); });
+          },
+          "Count the number of prime numbers up to the given limit (C++ implementation). "
+          "timeout and cancel work as for fibonacci_recursive",
+          py::arg("limit"), py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+    
+    def_metered(m, "matrix_multiplication", [](int size, const std::string& accumulator) -> py::array {
+              cpp_functions::Accumulator mode = parse_accumulator(accumulator);
+              if (mode == cpp_functions::Accumulator::int64) {
+                  cpp_functions::Matrix<std::int64_t> result;
+                  {
+                      py::gil_scoped_release release;
+                      result = cpp_functions::matrix_multiplication_int64(size);
+                  }
+                  return to_numpy(std::move(result));
+              }
+              if (mode == cpp_functions::Accumulator::int128) {
+                  throw py::value_error("matrix_multiplication supports accumulator 'int32', 'int64' or 'checked'");
+              }
+              cpp_functions::Matrix<int> result;
+              {
+                  py::gil_scoped_release release;
+                  result = cpp_functions::matrix_multiplication(size, mode);
+              }
+              return to_numpy(std::move(result));
+          },
+          "Perform matrix multiplication of two size x size matrices (C++ implementation). "
+          "Returns a 2-D NumPy array sharing the C++ result buffer: int32 for accumulator='int32' "
+          "(wraps for size >= 227) or 'checked' (raises OverflowError instead), int64 for 'int64'",
+          py::arg("size"), py::arg("accumulator") = "int32");
+    
+    def_metered(m, "matmul", &matmul,
+          "Multiply 2-D arrays a (m x k) and b (k x n) of dtype int32, int64, float32 or float64. "
+          "Strided inputs are read in place; pass out to reuse an m x n destination array. "
+          "threads > 1 splits the product across cores (0 = every pool thread); the GIL is released throughout. "
+          "algorithm='strassen' recurses Strassen-Winograd down to strassen_cutoff, then uses the "
+          "classical kernel. timeout and cancel work as for fibonacci_recursive; out is left "
+          "partially written when the call is stopped",
+          py::arg("a"), py::arg("b"), py::arg("out") = py::none(), py::arg("threads") = 1,
+          py::arg("algorithm") = "classical",
+          py::arg("strassen_cutoff") = static_cast<long long>(cpp_functions::kStrassenCutoff),
+          py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+    
+    def_metered(m, "matmul_async",
+          [](py::array a, py::array b, py::object out, int threads, const std::string& algorithm,
+             long long strassen_cutoff, py::object timeout, TokenPtr cancel) {
+              std::shared_ptr<MatmulJob> job =
+                  prepare_matmul(a, b, out, threads, algorithm, strassen_cutoff);
+              return submit_async([job] { job->run(); }, [job] { return job->finish(); },
+                                  timeout, cancel);
+          },
+          "Like matmul, but runs on the shared thread pool and returns an asyncio future of the "
+          "running loop. Do not modify a, b or out until the future is done. Cancelling the "
+          "future stops the multiply",
+          py::arg("a"), py::arg("b"), py::arg("out") = py::none(), py::arg("threads") = 1,
+          py::arg("algorithm") = "classical",
+          py::arg("strassen_cutoff") = static_cast<long long>(cpp_functions::kStrassenCutoff),
+          py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+    
+    // Optimized versions that leverage C++ capabilities
+    def_metered(m, "sum_of_squares_optimized",
+          [](long long n, const std::string& accumulator) {
+              return cpp_functions::sum_of_squares_optimized(n, parse_accumulator(accumulator));
+          },
+          "Calculate sum of squares using mathematical formula (C++ optimized). "
+          "accumulator is 'int64' (exact up to n = 3024616, wraps past it), 'checked' (raises "
+          "OverflowError past it) or 'int128' (the same result from 128-bit intermediates)",
+          py::arg("n"), py::arg("accumulator") = "int64");
+    
+    def_metered(m, "prime_count_optimized",
+          [](long long limit, int threads, const std::string& backend, py::object timeout,
+             TokenPtr cancel) {
+              cpp_functions::SieveBackend parsed = parse_backend(backend);
+              return call_interruptible(timeout, cancel, [limit, threads, parsed] {
+                  return cpp_functions::prime_count_optimized(limit, threads, parsed);
+              });
+          },
+          "Count primes using Sieve of Eratosthenes (C++ optimized). "
+          "threads > 1 sieves in parallel (0 = every pool thread); backend is 'segmented' (byte per odd) "
+          "or 'wheel30' (bit-packed mod-30 wheel). The GIL is released while counting; "
+          "timeout and cancel work as for fibonacci_recursive",
+          py::arg("limit"), py::arg("threads") = 1, py::arg("backend") = "segmented",
+          py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+    
+    def_metered(m, "prime_count_optimized_async",
+          [](long long limit, int threads, const std::string& backend, py::object timeout,
+             TokenPtr cancel) {
+              cpp_functions::SieveBackend parsed = parse_backend(backend);
+              return async_value([limit, threads, parsed] {
+                  return cpp_functions::prime_count_optimized(limit, threads, parsed);
+              }, timeout, cancel);
+          },
+          "Like prime_count_optimized, but runs on the shared thread pool and returns an "
+          "asyncio future of the running loop. Cancelling the future stops the sieve",
+          py::arg("limit"), py::arg("threads") = 1, py::arg("backend") = "segmented",
+          py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+    
+    def_metered(m, "prime_pi",
+          [](long long x, py::object timeout, TokenPtr cancel) {
+              return call_interruptible(timeout, cancel, [x] { return cpp_functions::prime_pi(x); });
+          },
+          "Count primes <= x using the Meissel-Lehmer method (C++ optimized, sublinear). "
+          "timeout and cancel work as for fibonacci_recursive",
+          py::arg("x"), py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+    
+    def_metered(m, "prime_pi_async",
+          [](long long x, py::object timeout, TokenPtr cancel) {
+              return async_value([x] { return cpp_functions::prime_pi(x); }, timeout, cancel);
+          },
+          "Like prime_pi, but runs on the shared thread pool and returns an asyncio future "
+          "of the running loop. Cancelling the future stops the computation",
+          py::arg("x"), py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+    
+    def_metered(m, "primes_up_to", [](long long limit) { return primes_array(0, limit); },
+          "Return all primes <= limit as a NumPy array (uint32, or uint64 past 2**32), without copying",
+          py::arg("limit"));
+    
+    def_metered(m, "primes_in_range", &primes_array,
+          "Return the primes in [lo, hi] as a NumPy array using the segmented sieve; "
+          "memory is proportional to the window, not to hi",
+          py::arg("lo"), py::arg("hi"));
+    
+    py::class_<cpp_functions::sieve::PrimeStream>(m, "PrimeStream",
+          "Iterate over the primes in [lo, hi] as NumPy chunks of at most chunk_size primes. "
+          "Only one sieve segment and one chunk are held in memory at a time")
+        .def(py::init(metered("PrimeStream.__init__", [](long long lo, long long hi, std::size_t chunk_size) {
+                 std::uint64_t first = static_cast<std::uint64_t>(std::max(lo, 0LL));
+                 std::uint64_t last = hi < 0 ? 0 : static_cast<std::uint64_t>(hi);
+                 return new cpp_functions::sieve::PrimeStream(first, last, chunk_size);
+             })),
+             py::arg("lo"), py::arg("hi"), py::arg("chunk_size") = 65536)
+        .def("__iter__", [](py::object self) { return self; })
+        .def("__next__", metered("PrimeStream.__next__", [](cpp_functions::sieve::PrimeStream& stream) {
+                 return stream.wide() ? next_chunk<std::uint64_t>(stream)
+                                      : next_chunk<std::uint32_t>(stream);
+             }))
+        .def_property_readonly("chunk_size", &cpp_functions::sieve::PrimeStream::chunk_size)
+        .def_property_readonly("exhausted", &cpp_functions::sieve::PrimeStream::exhausted);
+    
+    def_metered(m, "fibonacci_memoized", &cpp_functions::fibonacci_memoized,
+          "Calculate Fibonacci with memoization (C++ optimized)",
+          py::arg("n"));
+    
+    def_metered(m, "set_num_threads",
+          [](int threads, bool pin) {
+              if (threads < 0) {
+                  throw py::value_error("threads must be non-negative");
+              }
+              cpp_functions::set_num_threads(static_cast<unsigned>(threads), pin);
+          },
+          "Resize the thread pool shared by all parallel functions (caller included); "
+          "0 restores the default of one thread per available CPU. pin=True binds each "
+          "worker to its own CPU (Linux only)",
+          py::arg("threads"), py::arg("pin") = false, py::call_guard<py::gil_scoped_release>());
+    
+    def_metered(m, "get_num_threads", &cpp_functions::get_num_threads,
+          "Number of threads parallel functions use when passed threads=0");
+    
+    def_metered(m, "clear_caches", &cpp_functions::clear_caches,
+          "Reset the hit and miss counters of every memo cache. The caches are bounded and "
+          "immutable, so no entries are dropped");
+    
+    def_metered(m, "cache_stats", []() {
+              cpp_functions::CacheStats fib = cpp_functions::fibonacci_cache_stats();
+              py::dict stats;
+              stats["fibonacci_memoized"] = py::dict(
+                  py::arg("entries") = fib.entries, py::arg("capacity") = fib.capacity,
+                  py::arg("hits") = fib.hits, py::arg("misses") = fib.misses,
+                  py::arg("bytes") = fib.bytes);
+              return stats;
+          },
+          "Return {cache name: {entries, capacity, hits, misses, bytes}} for every memo cache");
+    
+    def_metered(m, "scratch_stats", []() {
+              const cpp_functions::scratch::Stats s = cpp_functions::scratch::stats();
+              py::dict stats;
+              stats["arenas"] = s.arenas;
+              stats["cached_bytes"] = s.cached_bytes;
+              stats["cached_blocks"] = s.cached_blocks;
+              stats["in_use_bytes"] = s.in_use_bytes;
+              stats["huge_page_bytes"] = s.huge_page_bytes;
+              stats["hits"] = s.hits;
+              stats["misses"] = s.misses;
+              stats["limit"] = cpp_functions::scratch::limit();
+              return stats;
+          },
+          "Per-thread scratch arenas kernels lease temporary buffers from: arenas, cached_bytes "
+          "and cached_blocks (idle, kept for reuse), in_use_bytes, huge_page_bytes (mapped in 2 MiB "
+          "aligned blocks), hits, misses and limit");
+    
+    def_metered(m, "scratch_trim", &cpp_functions::scratch::trim,
+          "Free every idle scratch block of every thread; buffers in use are unaffected",
+          py::call_guard<py::gil_scoped_release>());
+    
+    def_metered(m, "set_scratch_limit",
+          [](long long bytes) {
+              if (bytes < 0) {
+                  throw py::value_error("bytes must be non-negative");
+              }
+              cpp_functions::scratch::set_limit(static_cast<std::size_t>(bytes));
+          },
+          "Cap the idle bytes each thread's scratch arena keeps for reuse (default 64 MiB; "
+          "0 frees every buffer as soon as it is released). Arenas above the cap are trimmed now",
+          py::arg("bytes"), py::call_guard<py::gil_scoped_release>());
+    
+    def_metered(m, "fibonacci", [](long long n, py::object mod) -> py::object {
+              if (n < 0) {
+                  throw py::value_error("n must be >= 0");
+              }
+              unsigned long long k = static_cast<unsigned long long>(n);
+              if (!mod.is_none()) {
+                  unsigned long long m_value = mod.cast<unsigned long long>();
+                  unsigned long long result;
+                  {
+                      py::gil_scoped_release release;
+                      result = cpp_functions::fibonacci_mod(k, m_value);
+                  }
+                  return py::int_(result);
+              }
+              std::vector<std::uint32_t> limbs;
+              {
+                  py::gil_scoped_release release;
+                  limbs = cpp_functions::fibonacci_big(k);
+              }
+              return limbs_to_int(limbs);
+          },
+          "Calculate the nth Fibonacci number by fast doubling in O(log n) (C++ optimized). "
+          "Returns F(n) mod m when mod is given, otherwise the exact value as a Python int",
+          py::arg("n"), py::arg("mod") = py::none());
+    
+    // Batch versions: one Python -> C++ crossing per array instead of per element
+    def_batch(m, "sum_of_squares_batch", &cpp_functions::sum_of_squares_batch,
+              "Apply sum_of_squares to every element of an int64 array");
+    def_batch(m, "sum_of_squares_optimized_batch", &cpp_functions::sum_of_squares_optimized_batch,
+              "Apply sum_of_squares_optimized to every element of an int64 array (vectorized)");
+    def_batch(m, "fibonacci_recursive_batch", &cpp_functions::fibonacci_recursive_batch,
+              "Apply fibonacci_recursive to every element of an int64 array");
+    def_batch(m, "fibonacci_memoized_batch", &cpp_functions::fibonacci_memoized_batch,
+              "Apply fibonacci_memoized to every element of an int64 array");
+    def_batch(m, "prime_count_batch", &cpp_functions::prime_count_batch,
+              "Apply prime_count to every element of an int64 array");
+    def_batch(m, "prime_count_optimized_batch", &cpp_functions::prime_count_optimized_batch,
+              "Apply prime_count_optimized to every element of an int64 array using one sieve sweep");
+    def_metered(m, "is_prime",
+          [](const py::int_& n) {
+              if (n < py::int_(0)) {
+                  return false;
+              }
+              const unsigned long long value = PyLong_AsUnsignedLongLong(n.ptr());
+              if (value == ~0ULL && PyErr_Occurred()) {
+                  throw py::error_already_set();
+              }
+              return cpp_functions::is_prime(value);
+          },
+          "Deterministic primality test for any n < 2**64: a table lookup when n <= 65536 or "
+          "inside the loaded prime table, otherwise a small-prime screen and Miller-Rabin "
+          "with Montgomery multiplication (3 bases below 2**32, 7 above). Negative n is not "
+          "prime; n >= 2**64 raises OverflowError",
+          py::arg("n"));
+    
+    def_metered(m, "is_prime_batch", &is_prime_array,
+          "Return a bool array, shaped like values, marking which entries are prime, as "
+          "is_prime does. Survivors of the screen are tested four at a time so their "
+          "multiplies overlap. values must be non-negative integers",
+          py::arg("values"));
+    
+    // Persistent prime table consulted by the prime functions above
+    def_metered(m, "load_prime_table",
+          [](const std::string& path, long long limit, int threads, bool verify,
+             py::object timeout, TokenPtr cancel) {
+              if (limit < 0 || threads < 0) {
+                  throw py::value_error("limit and threads must be non-negative");
+              }
+              std::shared_ptr<const cpp_functions::sieve::PrimeTable> table =
+                  call_interruptible(timeout, cancel, [&path, limit, threads, verify] {
+                      return cpp_functions::sieve::open_or_build(path, static_cast<std::uint64_t>(limit),
+                                                                 static_cast<unsigned>(threads), verify);
+                  });
+              cpp_functions::sieve::set_active_table(table);
+              return prime_table_info(*table);
+          },
+          "Map the prime table file at path read-only and answer prime_count_optimized, prime_pi, "
+          "primes_in_range, primes_up_to, prime_count_optimized_batch and is_prime_batch from it "
+          "wherever it reaches. If the file is missing, invalid or smaller than limit and limit is "
+          "given, a table to limit is sieved on threads threads (0 = every pool thread), written to "
+          "path atomically and mapped. Processes mapping one file share its memory. verify checks "
+          "the checksum. Returns prime_table_info()",
+          py::arg("path"), py::arg("limit") = 0, py::arg("threads") = 0, py::arg("verify") = true,
+          py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+    
+    def_metered(m, "unload_prime_table",
+          []() { cpp_functions::sieve::set_active_table(nullptr); },
+          "Stop using the loaded prime table and unmap it once no running call needs it",
+          py::call_guard<py::gil_scoped_release>());
+    
+    def_metered(m, "prime_table_info", []() -> py::object {
+              const std::shared_ptr<const cpp_functions::sieve::PrimeTable> table =
+                  cpp_functions::sieve::active_table();
+              if (!table) {
+                  return py::none();
+              }
+              return prime_table_info(*table);
+          },
+          "Return {limit, primes, bytes, mapped} for the loaded prime table, or None");
+    
+    using cpp_functions::sieve::PrimeTable;
+    py::class_<PrimeTable, PrimeTablePtr>(m, "PrimeIndex",
+          "Bitset of the primes up to limit with a running count per 512-bit block. count(a, b) "
+          "is O(1), nth_prime(k) O(log limit) and next_prime(x) scans a few words; every query "
+          "releases the GIL and has a *_batch form for int64 arrays. Queries past limit raise "
+          "IndexError")
+        .def(py::init(metered("PrimeIndex.__init__", [](long long limit, int threads) {
+                 if (limit < 0 || threads < 0) {
+                     throw py::value_error("limit and threads must be non-negative");
+                 }
+                 // Only the sieve runs without the GIL: pybind11 registers the new
+                 // instance inside this factory's wrapper, which needs it held
+                 std::shared_ptr<const PrimeTable> table;
+                 {
+                     py::gil_scoped_release release;
+                     table = PrimeTable::build(static_cast<std::uint64_t>(limit),
+                                               static_cast<unsigned>(threads));
+                 }
+                 return prime_index(table);
+             })),
+             "Sieve [0, limit] on threads threads (0 = every pool thread)",
+             py::arg("limit"), py::arg("threads") = 0)
+        .def_static("open",
+             metered("PrimeIndex.open", [](const std::string& path, bool verify) {
+                 return prime_index(PrimeTable::open(path, verify));
+             }),
+             "Map a file written by save() or load_prime_table() read-only",
+             py::arg("path"), py::arg("verify") = true, py::call_guard<py::gil_scoped_release>())
+        .def("save", metered("PrimeIndex.save", [](const PrimeTable& self, const std::string& path) {
+                 self.save(path);
+             }),
+             "Write the index to path atomically, in the format load_prime_table() reads",
+             py::arg("path"), py::call_guard<py::gil_scoped_release>())
+        .def("activate", metered("PrimeIndex.activate", [](const PrimeTablePtr& self) {
+                 cpp_functions::sieve::set_active_table(self);
+             }),
+             "Answer the module's prime functions from this index, as load_prime_table() does",
+             py::call_guard<py::gil_scoped_release>())
+        .def("count",
+             metered("PrimeIndex.count", [](const PrimeTable& self, long long a, long long b) -> long long {
+                 const long long first = std::max(a, 0LL);
+                 return b < first ? 0
+                                  : static_cast<long long>(self.count(static_cast<std::uint64_t>(first),
+                                                                      static_cast<std::uint64_t>(b)));
+             }),
+             "Number of primes in [a, b]", py::arg("a"), py::arg("b"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("nth_prime",
+             metered("PrimeIndex.nth_prime", [](const PrimeTable& self, long long k) -> long long {
+                 if (k < 1) {
+                     throw py::index_error("k must be >= 1");
+                 }
+                 return static_cast<long long>(self.nth(static_cast<std::uint64_t>(k)));
+             }),
+             "The k-th prime, counting from nth_prime(1) == 2", py::arg("k"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("next_prime",
+             metered("PrimeIndex.next_prime", [](const PrimeTable& self, long long x) -> long long {
+                 return x < 0 ? 2 : static_cast<long long>(self.next_prime(static_cast<std::uint64_t>(x)));
+             }),
+             "Smallest prime greater than x", py::arg("x"), py::call_guard<py::gil_scoped_release>())
+        .def("is_prime",
+             metered("PrimeIndex.is_prime", [](const PrimeTable& self, long long n) {
+                 if (n > 0 && static_cast<std::uint64_t>(n) > self.limit()) {
+                     throw py::index_error("n lies beyond the index limit");
+                 }
+                 return n >= 0 && self.is_prime(static_cast<std::uint64_t>(n));
+             }),
+             "Whether n is prime", py::arg("n"))
+        .def("count_batch",
+             metered("PrimeIndex.count_batch", [](const PrimeTable& self, const Int64Array& a, const Int64Array& b) {
+                 if (a.size() != b.size()) {
+                     throw py::value_error("a and b must have the same number of elements");
+                 }
+                 const std::int64_t* lo = a.data();
+                 return query_batch(b, [&self, lo](const std::int64_t* hi, std::int64_t* out, std::size_t n) {
+                     self.count_batch(lo, hi, out, n);
+                 });
+             }),
+             "count(a[i], b[i]) for every element, shaped like b", py::arg("a"), py::arg("b"))
+        .def("nth_prime_batch",
+             metered("PrimeIndex.nth_prime_batch", [](const PrimeTable& self, const Int64Array& k) {
+                 return query_batch(k, [&self](const std::int64_t* in, std::int64_t* out, std::size_t n) {
+                     self.nth_batch(in, out, n);
+                 });
+             }),
+             "nth_prime(k[i]) for every element", py::arg("k"))
+        .def("next_prime_batch",
+             metered("PrimeIndex.next_prime_batch", [](const PrimeTable& self, const Int64Array& x) {
+                 return query_batch(x, [&self](const std::int64_t* in, std::int64_t* out, std::size_t n) {
+                     self.next_prime_batch(in, out, n);
+                 });
+             }),
+             "next_prime(x[i]) for every element", py::arg("x"))
+        .def_property_readonly("limit", &PrimeTable::limit)
+        .def_property_readonly("primes", &PrimeTable::total)
+        .def_property_readonly("nbytes", &PrimeTable::bytes)
+        .def_property_readonly("mapped", &PrimeTable::mapped)
+        .def("__len__", &PrimeTable::total)
+        .def("__repr__", [](const PrimeTable& self) {
+                 return "PrimeIndex(limit=" + std::to_string(self.limit()) + ", primes=" +
+                        std::to_string(self.total()) + (self.mapped() ? ", mapped" : "") + ")";
+             });
+    
+    // Wrapper functions for easier benchmarking
+    def_metered(m, "bench",
+          [](const std::string& name, const std::vector<long long>& args, unsigned repetitions,
+             unsigned warmup, double min_time, py::object timeout, TokenPtr cancel) {
+              if (!(min_time >= 0)) {
+                  throw py::value_error("min_time must be non-negative");
+              }
+              cpp_functions::bench::Config config;
+              config.repetitions = repetitions;
+              config.warmup = warmup;
+              config.min_sample_time = min_time;
+              cpp_functions::bench::Case c = cpp_functions::bench::make_case(name, args);
+              cpp_functions::bench::Stats stats = call_interruptible(timeout, cancel, [&c, &config] {
+                  return cpp_functions::bench::measure(c, config);
+              });
+              return stats_to_dict(name, args, stats);
+          },
+          "Time a kernel natively: warmup calls, calibrated batches of at least min_time seconds, then "
+          "repetitions samples. Returns per-call seconds (min, median, mean, p95, p99, max, stddev), the "
+          "coefficient of variation cv, items_per_second and gflops. bench_kernels() lists the names "
+          "and their args",
+          py::arg("name"), py::arg("args") = std::vector<long long>(), py::arg("repetitions") = 30,
+          py::arg("warmup") = 1, py::arg("min_time") = 1e-3, py::arg("timeout") = py::none(),
+          py::arg("cancel") = py::none());
+    
+    def_metered(m, "bench_kernels", []() {
+              py::dict kernels;
+              for (const std::string& name : cpp_functions::bench::kernel_names()) {
+                  kernels[py::str(name)] = cpp_functions::bench::kernel_signature(name);
+              }
+              return kernels;
+          },
+          "Kernels accepted by bench(), mapped to their argument lists");
+    
+    def_metered(m, "perf_counters",
+          [](const std::string& name, const std::vector<long long>& args, unsigned calls,
+             py::object timeout, TokenPtr cancel) {
+              cpp_functions::bench::Case c = cpp_functions::bench::make_case(name, args);
+              cpp_functions::perf::Reading reading = call_interruptible(timeout, cancel, [&c, calls] {
+                  return cpp_functions::perf::count(c.body, calls);
+              });
+              return reading_to_dict(name, args, reading);
+          },
+          "Run a bench() kernel calls times under the calling thread's hardware counters and return "
+          "per-call cycles, instructions, cache_references/cache_misses (last level), "
+          "branch_instructions/branch_misses, task_clock (ns), page_faults and context_switches, "
+          "plus ipc, cache_miss_rate and branch_miss_rate. Events the system refuses are omitted and "
+          "available is False without hardware counters (non-Linux, VMs, perf_event_paranoid > 2). "
+          "Pool threads are not counted, so keep threads=1",
+          py::arg("name"), py::arg("args") = std::vector<long long>(), py::arg("calls") = 1,
+          py::arg("timeout") = py::none(), py::arg("cancel") = py::none());
+    
+    def_metered(m, "perf_counters_available", &cpp_functions::perf::available,
+          "True when hardware performance counters can be read on this thread");
+    
+    def_metered(m, "cpu_features", []() {
+              const cpp_functions::CpuFeatures& f = cpp_functions::cpu_features();
+              py::dict features;
+              features["sse4_2"] = f.sse42;
+              features["popcnt"] = f.popcnt;
+              features["avx2"] = f.avx2;
+              features["fma"] = f.fma;
+              features["avx512f"] = f.avx512f;
+              features["neon"] = f.neon;
+              features["sve"] = f.sve;
+              py::dict kernels;
+              kernels["matmul_int32"] = cpp_functions::gemm_kernel_name<std::int32_t>();
+              kernels["matmul_int64"] = cpp_functions::gemm_kernel_name<std::int64_t>();
+              kernels["matmul_float32"] = cpp_functions::gemm_kernel_name<float>();
+              kernels["matmul_float64"] = cpp_functions::gemm_kernel_name<double>();
+              kernels["popcount"] = cpp_functions::sieve::popcount_kernel_name();
+              py::dict result;
+              result["arch"] = cpp_functions::cpu_arch();
+              result["simd"] = cpp_functions::simd_path_name(cpp_functions::simd_path());
+              result["features"] = features;
+              result["kernels"] = kernels;
+              return result;
+          },
+          "CPU features detected at import and the kernel paths in use: arch, simd (the widest "
+          "path: generic, sse42, avx2, avx512 or neon), features (sse4_2, popcnt, avx2, fma, "
+          "avx512f, neon, sve) and kernels (the path each dispatched kernel runs). "
+          "Set CPP_ACCELERATED_SIMD=<path> before import to force a narrower path");
+    
+    // Older single-kernel helpers, now timed by the harness: (result, mean seconds per call)
+    def_metered(m, "benchmark_sum_of_squares", [](int n, int iterations) {
+        long long result = cpp_functions::sum_of_squares(n);
+        return py::make_tuple(result, legacy_benchmark("sum_of_squares", n, iterations));
+    }, "Benchmark sum_of_squares function", py::arg("n"), py::arg("iterations") = 1);
+    
+    def_metered(m, "benchmark_prime_count", [](int limit, int iterations) {
+        int result = cpp_functions::prime_count(limit);
+        return py::make_tuple(result, legacy_benchmark("prime_count", limit, iterations));
+    }, "Benchmark prime_count function", py::arg("limit"), py::arg("iterations") = 1);
+    
+    def_metered(m, "benchmark_fibonacci", [](int n, int iterations) {
+        long long result = cpp_functions::fibonacci_recursive(n);
+        return py::make_tuple(result, legacy_benchmark("fibonacci_recursive", n, iterations));
+    }, "Benchmark fibonacci_recursive function", py::arg("n"), py::arg("iterations") = 1);
+    
+    def_metered(m, "benchmark_matrix_mult", [](int size, int iterations) {
+        cpp_functions::Matrix<int> result = cpp_functions::matrix_multiplication(size);
+        int sample = result.rows() > 0 ? result(0, 0) : 0;
+        return py::make_tuple(sample, legacy_benchmark("matrix_multiplication", size, iterations));
+    }, "Benchmark matrix_multiplication function", py::arg("size"), py::arg("iterations") = 1);
+    
+    // Call metrics of every binding above; these three are not metered themselves
+    m.def("metrics_snapshot", []() {
+              py::dict result;
+              for (const cpp_functions::metrics::FunctionMetrics& f : cpp_functions::metrics::snapshot()) {
+                  py::list histogram;
+                  for (std::size_t b = 0; b < f.buckets.size(); ++b) {
+                      if (f.buckets[b] != 0) {
+                          histogram.append(py::make_tuple(cpp_functions::metrics::bucket_upper_bound(b),
+                                                          f.buckets[b]));
+                      }
+                  }
+                  py::dict entry;
+                  entry["calls"] = f.calls;
+                  entry["errors"] = f.errors;
+                  entry["total_ns"] = f.total_ns;
+                  entry["mean_ns"] = static_cast<double>(f.total_ns) / static_cast<double>(f.calls);
+                  entry["p50_ns"] = f.percentile(0.5);
+                  entry["p90_ns"] = f.percentile(0.9);
+                  entry["p99_ns"] = f.percentile(0.99);
+                  entry["p999_ns"] = f.percentile(0.999);
+                  entry["histogram"] = histogram;
+                  result[py::str(f.name)] = entry;
+              }
+              return result;
+          },
+          "Per-function call metrics since the last metrics_reset(): calls, errors (calls that raised), "
+          "total_ns, mean_ns, latency percentiles p50/p90/p99/p999 (upper bounds, within 12.5%) and the "
+          "non-empty histogram buckets as (upper_bound_ns, count). Functions not called are omitted");
+    
+    m.def("metrics_reset", &cpp_functions::metrics::reset,
+          "Zero every call metric. Calls running at the time may be partly counted");
+    
+    m.def("metrics_prometheus",
+          [](const std::string& prefix) { return cpp_functions::metrics::prometheus_text(prefix); },
+          "metrics_snapshot() in the Prometheus text exposition format: <prefix>_calls_total, "
+          "<prefix>_errors_total and the <prefix>_call_duration_seconds histogram, per function label",
+          py::arg("prefix") = "cpp_accelerated");
 }
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include "scratch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "matrix.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#define CPP_SCRATCH_HUGE_PAGES 1
+#endif
+
+/**
+ * Each thread owns an Arena holding its idle blocks. Only that thread
+ * leases from or returns to it, so its mutex is uncontended except while
+ * trim() or stats() walk the registry from another thread.
+ */
+
+namespace cpp_functions {
+namespace scratch {
+
+namespace {
+
+/** Smallest block handed out; smaller requests share this size class. */
+constexpr std::size_t kMinBlockBytes = 4096;
+
+std::atomic<std::size_t> g_limit{kDefaultLimit};
+std::atomic<std::size_t> g_in_use{0};
+std::atomic<std::size_t> g_huge{0};
+std::atomic<std::uint64_t> g_hits{0};
+std::atomic<std::uint64_t> g_misses{0};
+
+/** Powers of two below kHugePageBytes, whole huge pages from there on. */
+std::size_t block_capacity(std::size_t bytes) {
+    if (bytes >= kHugePageBytes) {
+        return (bytes + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+    }
+    std::size_t capacity = kMinBlockBytes;
+    while (capacity < bytes) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+void* allocate_block(std::size_t capacity) {
+#if defined(CPP_SCRATCH_HUGE_PAGES)
+    if (capacity >= kHugePageBytes) {
+        // Over-map by one huge page and unmap the slack on both sides so the
+        // block starts on a 2 MiB boundary, which THP needs to back it
+        const std::size_t span = capacity + kHugePageBytes;
+        void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw);
+        const std::uintptr_t aligned = (start + kHugePageBytes - 1) & ~(std::uintptr_t(kHugePageBytes) - 1);
+        if (aligned > start) {
+            munmap(raw, aligned - start);
+        }
+        const std::uintptr_t tail = start + span - (aligned + capacity);
+        if (tail > 0) {
+            munmap(reinterpret_cast<void*>(aligned + capacity), tail);
+        }
+        void* block = reinterpret_cast<void*>(aligned);
+#if defined(MADV_HUGEPAGE)
+        madvise(block, capacity, MADV_HUGEPAGE);
+#endif
+        g_huge.fetch_add(capacity, std::memory_order_relaxed);
+        return block;
+    }
+#endif
+    return aligned_allocate(capacity);
+}
+
+void free_block(void* block, std::size_t capacity) {
+#if defined(CPP_SCRATCH_HUGE_PAGES)
+    if (capacity >= kHugePageBytes) {
+        munmap(block, capacity);
+        g_huge.fetch_sub(capacity, std::memory_order_relaxed);
+        return;
+    }
+#endif
+    aligned_deallocate(block);
+}
+
+struct Idle {
+    void* data;
+    std::size_t capacity;
+};
+
+class Arena {
+public:
+    ~Arena() { trim_to(0); }
+
+    /** The smallest idle block holding capacity without wasting half; data is null if none. */
+    Idle take(std::size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t best = idle_.size();
+        for (std::size_t i = 0; i < idle_.size(); ++i) {
+            const std::size_t have = idle_[i].capacity;
+            if (have >= capacity && have / 2 < capacity &&
+                (best == idle_.size() || have < idle_[best].capacity)) {
+                best = i;
+            }
+        }
+        if (best == idle_.size()) {
+            return Idle{nullptr, 0};
+        }
+        const Idle block = idle_[best];
+        cached_ -= block.capacity;
+        idle_.erase(idle_.begin() + static_cast<std::ptrdiff_t>(best));
+        return block;
+    }
+
+    /** Keep block for reuse, evicting the oldest idle blocks past the limit. */
+    void give(void* block, std::size_t capacity) {
+        const std::size_t cap = g_limit.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (capacity > cap) {
+            free_block(block, capacity);
+            return;
+        }
+        evict(cap - capacity);
+        idle_.push_back(Idle{block, capacity});  // may throw; the caller then frees block
+        cached_ += capacity;
+    }
+
+    void trim_to(std::size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        evict(bytes);
+    }
+
+    void add_to(Stats& s) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        s.cached_bytes += cached_;
+        s.cached_blocks += idle_.size();
+    }
+
+private:
+    /** Free the oldest idle blocks until at most bytes stay cached. */
+    void evict(std::size_t bytes) {
+        std::size_t drop = 0;
+        while (drop < idle_.size() && cached_ > bytes) {
+            free_block(idle_[drop].data, idle_[drop].capacity);
+            cached_ -= idle_[drop].capacity;
+            ++drop;
+        }
+        idle_.erase(idle_.begin(), idle_.begin() + static_cast<std::ptrdiff_t>(drop));
+    }
+
+    std::mutex mutex_;
+    std::vector<Idle> idle_;  // oldest first
+    std::size_t cached_ = 0;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<Arena*> arenas;
+};
+
+/** The calling thread's arena, once it has one. */
+thread_local Arena* t_arena = nullptr;
+
+/** Set once the calling thread's arena is gone; later returns are freed. */
+thread_local bool t_arena_destroyed = false;
+
+Registry& registry();
+
+#if defined(__unix__) || defined(__APPLE__)
+void before_fork() { registry().mutex.lock(); }
+void after_fork_parent() { registry().mutex.unlock(); }
+void after_fork_child() {
+    // Only the forking thread survives. The other arenas are abandoned with
+    // their blocks, and with any arena mutex their dead owners held
+    Registry& r = registry();
+    r.arenas.assign(t_arena ? 1 : 0, t_arena);
+    r.mutex.unlock();
+}
+#endif
+
+/** Leaked so threads exiting during static destruction can still unregister. */
+Registry& registry() {
+    static Registry* instance = [] {
+#if defined(__unix__) || defined(__APPLE__)
+        pthread_atfork(before_fork, after_fork_parent, after_fork_child);
+#endif
+        return new Registry;
+    }();
+    return *instance;
+}
+
+class ArenaOwner {
+public:
+    ArenaOwner() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.arenas.push_back(&arena_);
+        t_arena = &arena_;
+    }
+
+    ~ArenaOwner() {
+        {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.arenas.erase(std::find(r.arenas.begin(), r.arenas.end(), &arena_));
+        }
+        t_arena = nullptr;
+        t_arena_destroyed = true;
+    }
+
+    Arena& arena() { return arena_; }
+
+private:
+    Arena arena_;
+};
+
+Arena& local_arena() {
+    thread_local ArenaOwner owner;
+    return owner.arena();
+}
+
+} // namespace
+
+Block::Block(std::size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    const std::size_t capacity = block_capacity(bytes);
+    Idle block = t_arena_destroyed ? Idle{nullptr, 0} : local_arena().take(capacity);
+    if (block.data) {
+        g_hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        block = Idle{allocate_block(capacity), capacity};
+        g_misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    data_ = block.data;
+    capacity_ = block.capacity;
+    g_in_use.fetch_add(capacity_, std::memory_order_relaxed);
+}
+
+void Block::release() noexcept {
+    if (!data_) {
+        return;
+    }
+    g_in_use.fetch_sub(capacity_, std::memory_order_relaxed);
+    bool kept = false;
+    if (!t_arena_destroyed) {
+        try {
+            local_arena().give(data_, capacity_);
+            kept = true;
+        } catch (const std::bad_alloc&) {
+            // No room to remember the block: just free it
+        }
+    }
+    if (!kept) {
+        free_block(data_, capacity_);
+    }
+    data_ = nullptr;
+    capacity_ = 0;
+}
+
+void set_limit(std::size_t bytes) {
+    g_limit.store(bytes, std::memory_order_relaxed);
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (Arena* arena : r.arenas) {
+        arena->trim_to(bytes);
+    }
+}
+
+std::size_t limit() {
+    return g_limit.load(std::memory_order_relaxed);
+}
+
+void trim() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (Arena* arena : r.arenas) {
+        arena->trim_to(0);
+    }
+}
+
+Stats stats() {
+    Stats s;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        s.arenas = r.arenas.size();
+        for (Arena* arena : r.arenas) {
+            arena->add_to(s);
+        }
+    }
+    s.in_use_bytes = g_in_use.load(std::memory_order_relaxed);
+    s.huge_page_bytes = g_huge.load(std::memory_order_relaxed);
+    s.hits = g_hits.load(std::memory_order_relaxed);
+    s.misses = g_misses.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace scratch
+} // namespace cpp_functions
@@ -0,0 +1,125 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Per-thread scratch memory for kernel temporaries.
+ * Packing panels, sieve segments and similar buffers are leased from an
+ * arena owned by the calling thread and handed back when the lease ends,
+ * so repeated calls reuse memory that is already mapped and warm instead
+ * of paying for malloc, free and fresh page faults every time. Requests are
+ * rounded up to a power of two; blocks of 2 MiB and more get their own
+ * 2 MiB-aligned mapping advised for transparent huge pages (Linux). An
+ * arena keeps at most limit() idle bytes and frees the oldest beyond that.
+ */
+
+namespace cpp_functions {
+namespace scratch {
+
+/** Blocks at least this large are mapped on their own, huge-page aligned. */
+constexpr std::size_t kHugePageBytes = std::size_t(2) << 20;
+
+/** Idle bytes each arena keeps until set_limit() says otherwise. */
+constexpr std::size_t kDefaultLimit = std::size_t(64) << 20;
+
+/**
+ * Lease of at least bytes of uninitialized, 64-byte aligned memory from
+ * the calling thread's arena; Block(0) holds nothing. Move-only. The
+ * memory goes back to the arena of the thread that ends the lease.
+ * Throws std::bad_alloc.
+ */
+class Block {
+public:
+    Block() = default;
+    explicit Block(std::size_t bytes);
+    ~Block() { release(); }
+
+    Block(Block&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), capacity_(std::exchange(other.capacity_, 0)) {}
+    Block& operator=(Block&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+    Block(const Block&) = delete;
+    Block& operator=(const Block&) = delete;
+
+    void* data() const { return data_; }
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    void release() noexcept;
+
+    void* data_ = nullptr;
+    std::size_t capacity_ = 0;
+};
+
+/** n uninitialized elements of T in one leased Block. */
+template <typename T>
+class Array {
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "scratch::Array holds raw, unconstructed memory");
+
+public:
+    Array() = default;
+    explicit Array(std::size_t n) : block_(n * sizeof(T)), size_(n) {}
+
+    Array(Array&& other) noexcept
+        : block_(std::move(other.block_)), size_(std::exchange(other.size_, 0)) {}
+    Array& operator=(Array&& other) noexcept {
+        block_ = std::move(other.block_);
+        size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    T* data() { return static_cast<T*>(block_.data()); }
+    const T* data() const { return static_cast<const T*>(block_.data()); }
+    std::size_t size() const { return size_; }
+
+    T& operator[](std::size_t i) { return data()[i]; }
+    const T& operator[](std::size_t i) const { return data()[i]; }
+
+private:
+    Block block_;
+    std::size_t size_ = 0;
+};
+
+/**
+ * Cap the idle bytes every arena keeps (0 = keep nothing). Arenas already
+ * above the new cap are trimmed down to it immediately.
+ */
+void set_limit(std::size_t bytes);
+
+/** Current cap on idle bytes per arena. */
+std::size_t limit();
+
+/**
+ * Free the idle blocks of every thread's arena. Leases in use are not
+ * affected and return to their arena as usual when they end.
+ */
+void trim();
+
+/** Process-wide arena totals. */
+struct Stats {
+    std::size_t arenas = 0;           // threads that have leased scratch memory
+    std::size_t cached_bytes = 0;     // idle, kept for reuse
+    std::size_t cached_blocks = 0;
+    std::size_t in_use_bytes = 0;     // leased right now
+    std::size_t huge_page_bytes = 0;  // of cached + in use, in huge-page mappings
+    std::uint64_t hits = 0;           // leases served from an idle block
+    std::uint64_t misses = 0;         // leases that had to allocate
+};
+
+Stats stats();
+
+} // namespace scratch
+} // namespace cpp_functions
+
+#endif // SCRATCH_H
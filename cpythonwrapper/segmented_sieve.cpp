@@ -0,0 +1,282 @@
+#include "segmented_sieve.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+#include "cancellation.h"
+#include "thread_pool.h"
+
+/**
+ * Segmented sieve of Eratosthenes.
+ * Each segment is a byte array over odd numbers only; base primes keep their
+ * next multiple between segments so no division is needed after setup.
+ */
+
+namespace cpp_functions {
+namespace sieve {
+
+std::uint64_t isqrt(std::uint64_t n) {
+    std::uint64_t r = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)));
+    // Correct the floating point estimate in both directions
+    while (r > 0 && (r > UINT32_MAX || r * r > n)) {
+        --r;
+    }
+    while (r < UINT32_MAX && (r + 1) * (r + 1) <= n) {
+        ++r;
+    }
+    return r;
+}
+
+std::vector<std::uint32_t> base_primes(std::uint64_t limit) {
+    std::vector<std::uint32_t> primes;
+    std::uint64_t root = isqrt(limit);
+    if (root < 3) {
+        return primes;
+    }
+
+    if (root <= small::kPrimeTableLimit) {
+        const std::uint32_t last = static_cast<std::uint32_t>(root);
+        primes.reserve(small::kPrimes.count(last) - 1);
+        small::for_each_prime(3, last, [&primes](std::uint32_t p) { primes.push_back(p); });
+        return primes;
+    }
+
+    // flags[i] represents the odd number 2 * i + 1
+    scratch::Array<std::uint8_t> flags(static_cast<std::size_t>(root / 2 + 1));
+    std::fill(flags.data(), flags.data() + flags.size(), static_cast<std::uint8_t>(1));
+    for (std::uint64_t i = 3; i * i <= root; i += 2) {
+        if (flags[i / 2]) {
+            for (std::uint64_t j = i * i; j <= root; j += 2 * i) {
+                flags[j / 2] = 0;
+            }
+        }
+    }
+
+    for (std::uint64_t i = 3; i <= root; i += 2) {
+        if (flags[i / 2]) {
+            primes.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    return primes;
+}
+
+std::size_t segment_bytes_for(std::uint64_t hi) {
+    // A segment of n bytes covers 2 * n integers; aim to cover sqrt(hi)
+    std::uint64_t wanted = isqrt(hi) / 2;
+    std::uint64_t clamped = std::min<std::uint64_t>(
+        std::max<std::uint64_t>(wanted, kL1SegmentBytes), kL2SegmentBytes);
+    return static_cast<std::size_t>(clamped);
+}
+
+SegmentedSieve::SegmentedSieve(std::uint64_t lo, std::uint64_t hi,
+                               std::size_t segment_bytes) {
+    init(lo, hi, segment_bytes);
+    if (odd_count_ > 0) {
+        primes_ = base_primes(hi);
+    }
+    init_multiples();
+}
+
+SegmentedSieve::SegmentedSieve(std::uint64_t lo, std::uint64_t hi,
+                               const std::vector<std::uint32_t>& primes,
+                               std::size_t segment_bytes) {
+    init(lo, hi, segment_bytes);
+    if (odd_count_ > 0) {
+        // Keep only the primes this range actually needs
+        std::uint64_t root = isqrt(hi);
+        auto last = std::upper_bound(primes.begin(), primes.end(), root);
+        primes_.assign(primes.begin(), last);
+    }
+    init_multiples();
+}
+
+void SegmentedSieve::init(std::uint64_t lo, std::uint64_t hi,
+                          std::size_t segment_bytes) {
+    has_two_ = lo <= 2 && hi >= 2;
+
+    odd_lo_ = std::max<std::uint64_t>(lo, 3);
+    if (odd_lo_ % 2 == 0) {
+        ++odd_lo_;
+    }
+    odd_count_ = (hi >= odd_lo_) ? (hi - odd_lo_) / 2 + 1 : 0;
+    if (odd_count_ == 0) {
+        return;
+    }
+
+    if (segment_bytes == 0) {
+        segment_bytes = segment_bytes_for(hi);
+    }
+    segment_ = scratch::Array<std::uint8_t>(static_cast<std::size_t>(
+        std::min<std::uint64_t>(segment_bytes, odd_count_)));
+}
+
+void SegmentedSieve::init_multiples() {
+    next_ = scratch::Array<std::uint64_t>(primes_.size());
+    for (std::size_t k = 0; k < primes_.size(); ++k) {
+        std::uint64_t p = primes_[k];
+        std::uint64_t square = p * p;
+        if (square >= odd_lo_) {
+            next_[k] = (square - odd_lo_) / 2;
+            continue;
+        }
+        // Distance from odd_lo_ to its first odd multiple of p. Working relative
+        // to the window never forms a value past hi, which could wrap near 2^64;
+        // a distance beyond the window only means p never strikes it.
+        std::uint64_t rem = odd_lo_ % p;
+        std::uint64_t dist = rem ? p - rem : 0;
+        if (dist % 2 == 1) {
+            // odd_lo_ is odd, so an odd distance lands on an even multiple
+            dist += p;
+        }
+        next_[k] = dist / 2;
+    }
+}
+
+bool SegmentedSieve::next() {
+    emit_two_ = has_two_;
+    has_two_ = false;
+
+    if (position_ >= odd_count_) {
+        segment_len_ = 0;
+        return emit_two_;
+    }
+    cancellation_point();
+
+    std::size_t len = static_cast<std::size_t>(
+        std::min<std::uint64_t>(segment_.size(), odd_count_ - position_));
+    std::uint64_t end = position_ + len;
+    segment_low_ = odd_lo_ + 2 * position_;
+    std::uint64_t segment_high = segment_low_ + 2 * (len - 1);
+
+    // Only primes whose square lies at or below this segment can strike it
+    while (active_ < primes_.size() &&
+           static_cast<std::uint64_t>(primes_[active_]) * primes_[active_] <= segment_high) {
+        ++active_;
+    }
+
+    std::uint8_t* flags = segment_.data();
+    std::fill(flags, flags + len, static_cast<std::uint8_t>(1));
+    for (std::size_t k = 0; k < active_; ++k) {
+        std::uint64_t j = next_[k];
+        if (j >= end) {
+            continue;
+        }
+        const std::uint64_t p = primes_[k];
+        for (j -= position_; j < len; j += p) {
+            flags[j] = 0;
+        }
+        next_[k] = position_ + j;
+    }
+
+    segment_len_ = len;
+    position_ = end;
+    return true;
+}
+
+std::uint64_t SegmentedSieve::count() const {
+    std::uint64_t total = emit_two_ ? 1 : 0;
+    const std::uint8_t* flags = segment_.data();
+    for (std::size_t i = 0; i < segment_len_; ++i) {
+        total += flags[i];
+    }
+    return total;
+}
+
+PrimeStream::PrimeStream(std::uint64_t lo, std::uint64_t hi, std::size_t chunk_size)
+    : sieve_(lo, hi), chunk_size_(chunk_size), hi_(hi) {
+    if (chunk_size == 0) {
+        throw std::invalid_argument("chunk_size must be positive");
+    }
+}
+
+bool PrimeStream::refill() {
+    pending_.clear();
+    pending_pos_ = 0;
+    while (!exhausted_ && pending_.empty()) {
+        if (!sieve_.next()) {
+            exhausted_ = true;
+            break;
+        }
+        sieve_.for_each_prime([this](std::uint64_t p) { pending_.push_back(p); });
+    }
+    return !pending_.empty();
+}
+
+std::uint64_t count_primes(std::uint64_t lo, std::uint64_t hi) {
+    if (hi < lo) {
+        return 0;
+    }
+    SegmentedSieve sieve(lo, hi);
+    std::uint64_t total = 0;
+    while (sieve.next()) {
+        total += sieve.count();
+    }
+    return total;
+}
+
+std::size_t prime_count_estimate(std::uint64_t lo, std::uint64_t hi) {
+    if (hi < lo || hi < 2) {
+        return 0;
+    }
+    // pi(b) - pi(a) <= 2 * (b - a) / ln(b - a) (Montgomery-Vaughan) bounds
+    // short windows; the whole-range bound 1.26 * x / ln(x) covers the rest
+    double width = static_cast<double>(hi - lo) + 1.0;
+    double bound = 1.26 * static_cast<double>(hi) / std::log(static_cast<double>(std::max<std::uint64_t>(hi, 3)));
+    bound = std::min(bound, width);
+    if (width > 2.0) {
+        bound = std::min(bound, 2.0 * width / std::log(width));
+    }
+    return static_cast<std::size_t>(bound) + 2;
+}
+
+std::uint64_t parallel_count(
+    std::uint64_t lo, std::uint64_t hi, unsigned threads, std::uint64_t span,
+    const std::function<std::uint64_t(std::uint64_t, std::uint64_t)>& count_chunk) {
+    if (hi < lo) {
+        return 0;
+    }
+    threads = resolve_threads(threads);
+
+    // Chunks are whole multiples of the segment span so every worker sieves
+    // full segments; a few chunks per thread keeps the load balanced
+    const std::uint64_t length = hi - lo;
+    std::uint64_t chunk = length / (static_cast<std::uint64_t>(threads) * 4) + 1;
+    chunk = std::max<std::uint64_t>((chunk + span - 1) / span, 1) * span;
+    const std::uint64_t chunks = length / chunk + 1;
+
+    if (threads == 1 || chunks == 1) {
+        return count_chunk(lo, hi);
+    }
+
+    std::atomic<std::uint64_t> total(0);
+    parallel_for(static_cast<std::size_t>(chunks), threads, [&](std::size_t c) {
+        std::uint64_t chunk_lo = lo + c * chunk;
+        std::uint64_t chunk_hi = (hi - chunk_lo < chunk) ? hi : chunk_lo + chunk - 1;
+        total.fetch_add(count_chunk(chunk_lo, chunk_hi), std::memory_order_relaxed);
+    });
+    return total.load();
+}
+
+std::uint64_t count_primes_parallel(std::uint64_t lo, std::uint64_t hi,
+                                    unsigned threads) {
+    if (hi < lo) {
+        return 0;
+    }
+    const std::vector<std::uint32_t> primes = base_primes(hi);
+    const std::uint64_t span = 2 * static_cast<std::uint64_t>(segment_bytes_for(hi));
+    return parallel_count(lo, hi, threads, span,
+                          [&primes](std::uint64_t chunk_lo, std::uint64_t chunk_hi) {
+        SegmentedSieve sieve(chunk_lo, chunk_hi, primes);
+        std::uint64_t total = 0;
+        while (sieve.next()) {
+            total += sieve.count();
+        }
+        return total;
+    });
+}
+
+} // namespace sieve
+} // namespace cpp_functions
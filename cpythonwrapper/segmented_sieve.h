@@ -0,0 +1,242 @@
+#ifndef SEGMENTED_SIEVE_H
+#define SEGMENTED_SIEVE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "prime_table.h"
+#include "scratch.h"
+#include "small_tables.h"
+
+/**
+ * Segmented sieve of Eratosthenes.
+ * The range [lo, hi] is processed in cache-sized windows that only store odd
+ * numbers, so memory use is O(sqrt(hi)) regardless of how large the range is.
+ * Segments and per-prime state are leased from the thread's scratch arena.
+ */
+
+namespace cpp_functions {
+namespace sieve {
+
+/** Segment size (bytes) used for small ranges, sized to fit in L1 data cache. */
+constexpr std::size_t kL1SegmentBytes = 32 * 1024;
+
+/** Largest segment size (bytes), sized to fit in L2 cache. */
+constexpr std::size_t kL2SegmentBytes = 256 * 1024;
+
+/**
+ * Integer square root: the largest r with r * r <= n.
+ */
+std::uint64_t isqrt(std::uint64_t n);
+
+/**
+ * Return all odd primes p with p * p <= limit.
+ * This is the base-prime table used to cross off composites in each segment.
+ */
+std::vector<std::uint32_t> base_primes(std::uint64_t limit);
+
+/**
+ * Pick a segment size for sieving up to hi: L1-sized for small ranges,
+ * growing towards L2 so that large base primes still hit every segment.
+ */
+std::size_t segment_bytes_for(std::uint64_t hi);
+
+/**
+ * Sieve over [lo, hi] one segment at a time.
+ *
+ * Usage:
+ *     SegmentedSieve s(lo, hi);
+ *     while (s.next()) { total += s.count(); }
+ */
+class SegmentedSieve {
+public:
+    SegmentedSieve(std::uint64_t lo, std::uint64_t hi,
+                   std::size_t segment_bytes = 0);
+
+    /**
+     * Construct from a base-prime table shared with other sieves, e.g. one
+     * per worker thread. The table must cover sqrt(hi).
+     */
+    SegmentedSieve(std::uint64_t lo, std::uint64_t hi,
+                   const std::vector<std::uint32_t>& primes,
+                   std::size_t segment_bytes = 0);
+
+    /**
+     * Sieve the next segment. Returns false once the range is exhausted.
+     */
+    bool next();
+
+    /**
+     * Number of primes in the current segment.
+     */
+    std::uint64_t count() const;
+
+    /**
+     * Call fn(p) for every prime p in the current segment, in increasing order.
+     */
+    template <typename Fn>
+    void for_each_prime(Fn&& fn) const {
+        if (emit_two_) {
+            fn(static_cast<std::uint64_t>(2));
+        }
+        const std::uint8_t* flags = segment_.data();
+        for (std::size_t i = 0; i < segment_len_; ++i) {
+            if (flags[i]) {
+                fn(segment_low_ + 2 * static_cast<std::uint64_t>(i));
+            }
+        }
+    }
+
+    /** Smallest odd value represented by the current segment. */
+    std::uint64_t segment_low() const { return segment_low_; }
+
+    /** Number of odd values held by the current segment. */
+    std::size_t segment_length() const { return segment_len_; }
+
+    /** Flags of the current segment: entry i is 1 iff segment_low() + 2 i is prime. */
+    const std::uint8_t* segment_flags() const { return segment_.data(); }
+
+private:
+    void init(std::uint64_t lo, std::uint64_t hi, std::size_t segment_bytes);
+    void init_multiples();
+
+    std::vector<std::uint32_t> primes_;     // odd base primes <= sqrt(hi)
+    scratch::Array<std::uint64_t> next_;    // next odd-index multiple per prime
+    scratch::Array<std::uint8_t> segment_;  // 1 = prime candidate, one byte per odd
+    std::uint64_t odd_lo_ = 0;              // first odd value of the range
+    std::uint64_t odd_count_ = 0;           // total odd values in the range
+    std::uint64_t position_ = 0;            // odd index of the next segment
+    std::size_t active_ = 0;                // primes whose square is reached
+    std::uint64_t segment_low_ = 0;
+    std::size_t segment_len_ = 0;
+    bool has_two_ = false;
+    bool emit_two_ = false;
+};
+
+/**
+ * Incremental prime generator over [lo, hi].
+ * Holds one sieve segment at a time and hands out primes in chunks of at
+ * most chunk_size, so peak memory is bounded by the segment plus one chunk.
+ */
+class PrimeStream {
+public:
+    PrimeStream(std::uint64_t lo, std::uint64_t hi, std::size_t chunk_size);
+
+    /**
+     * Write up to chunk_size() primes to out and return how many were
+     * written; 0 means the stream is exhausted.
+     */
+    template <typename T>
+    std::size_t fill(T* out) {
+        std::size_t written = 0;
+        while (written < chunk_size_) {
+            if (pending_pos_ == pending_.size() && !refill()) {
+                break;
+            }
+            std::size_t take = std::min(chunk_size_ - written, pending_.size() - pending_pos_);
+            const std::uint64_t* src = pending_.data() + pending_pos_;
+            for (std::size_t i = 0; i < take; ++i) {
+                out[written + i] = static_cast<T>(src[i]);
+            }
+            written += take;
+            pending_pos_ += take;
+        }
+        return written;
+    }
+
+    /** Maximum number of primes returned by one fill(). */
+    std::size_t chunk_size() const { return chunk_size_; }
+
+    /** True when values above 2^32 - 1 can appear, i.e. 64-bit output is needed. */
+    bool wide() const { return hi_ > UINT32_MAX; }
+
+    /** True once every prime in the range has been handed out. */
+    bool exhausted() const { return exhausted_ && pending_pos_ == pending_.size(); }
+
+private:
+    bool refill();
+
+    SegmentedSieve sieve_;
+    std::vector<std::uint64_t> pending_;  // primes of the current segment
+    std::size_t pending_pos_ = 0;
+    std::size_t chunk_size_;
+    std::uint64_t hi_;
+    bool exhausted_ = false;
+};
+
+/**
+ * Count primes in [lo, hi] with the segmented sieve.
+ */
+std::uint64_t count_primes(std::uint64_t lo, std::uint64_t hi);
+
+/**
+ * Upper bound on the number of primes in [lo, hi], used to size output
+ * buffers so collecting primes does not reallocate.
+ */
+std::size_t prime_count_estimate(std::uint64_t lo, std::uint64_t hi);
+
+/**
+ * Collect the primes in [lo, hi] into a vector of T.
+ * Only one segment is resident at a time, so memory is the output plus
+ * O(sqrt(hi)) however far from zero the window lies. Windows inside the
+ * compile-time table or the active prime table are read straight from
+ * their bitmap.
+ */
+template <typename T>
+std::vector<T> collect_primes(std::uint64_t lo, std::uint64_t hi) {
+    std::vector<T> primes;
+    if (hi < lo) {
+        return primes;
+    }
+    if (hi <= small::kPrimeTableLimit) {
+        const std::uint32_t first = static_cast<std::uint32_t>(lo);
+        const std::uint32_t last = static_cast<std::uint32_t>(hi);
+        primes.reserve(small::kPrimes.count(last) - (first > 0 ? small::kPrimes.count(first - 1) : 0));
+        small::for_each_prime(first, last, [&primes](std::uint32_t p) {
+            primes.push_back(static_cast<T>(p));
+        });
+        return primes;
+    }
+    const std::shared_ptr<const PrimeTable> table = active_table();
+    if (table && hi <= table->limit()) {
+        primes.reserve(static_cast<std::size_t>(table->count(hi) - (lo > 0 ? table->count(lo - 1) : 0)));
+        table->for_each_prime(lo, hi, [&primes](std::uint64_t p) {
+            primes.push_back(static_cast<T>(p));
+        });
+        return primes;
+    }
+    primes.reserve(prime_count_estimate(lo, hi));
+    SegmentedSieve sieve(lo, hi);
+    while (sieve.next()) {
+        sieve.for_each_prime([&primes](std::uint64_t p) {
+            primes.push_back(static_cast<T>(p));
+        });
+    }
+    return primes;
+}
+
+/**
+ * Split [lo, hi] into chunks that are multiples of span and sum
+ * count_chunk(chunk_lo, chunk_hi) over them on up to threads threads of the
+ * shared pool. Chunks are claimed dynamically; threads == 0 means the whole
+ * pool (get_num_threads()).
+ */
+std::uint64_t parallel_count(
+    std::uint64_t lo, std::uint64_t hi, unsigned threads, std::uint64_t span,
+    const std::function<std::uint64_t(std::uint64_t, std::uint64_t)>& count_chunk);
+
+/**
+ * Count primes in [lo, hi] using several threads.
+ * The range is cut into segment-aligned chunks that pool threads claim
+ * dynamically. threads == 0 means every thread of the shared pool.
+ */
+std::uint64_t count_primes_parallel(std::uint64_t lo, std::uint64_t hi,
+                                    unsigned threads);
+
+} // namespace sieve
+} // namespace cpp_functions
+
+#endif // SEGMENTED_SIEVE_H
@@ -1,76 +1,128 @@
-"""
-Setup script for building the C++ accelerated Python extension.
-This script uses pybind11 to create a Python module from C++ code.
-"""
-
-from setuptools import setup, Extension
-from pybind11.setup_helpers import Pybind11Extension, build_ext
-from pybind11 import get_cmake_dir
-import pybind11
-
-# Define the extension module
-ext_modules = [
-    Pybind11Extension(
-        "cpp_accelerated",  # Module name
-        sources=[
-            "pybind_wrapper.cpp",
-            "cpp_functions.cpp",
-        ],
-        include_dirs=[
-            # Path to pybind11 headers
-            pybind11.get_include(),
-        ],
-        language='c++',
-        cxx_std=14,  # C++14 standard
-        # Force correct architecture
-        define_macros=[('VERSION_INFO', '"dev"')],
-        extra_compile_args=["-arch", "arm64"],
-        extra_link_args=["-arch", "arm64"],
-    ),
-]
-
-setup(
-    name="cpp_accelerated",
-    version="1.0.0",
-    author="Python C++ Performance Comparison",
-    author_email="",
-    description="C++ accelerated functions for Python performance comparison",
-    long_description="""
-    This package provides C++ implementations of computationally intensive functions
-    that can be called from Python for significant performance improvements.
-    
-    Features:
-    - Sum of squares calculation
-    - Fibonacci sequence generation
-    - Prime number counting
-    - Matrix multiplication
-    - Optimized versions using advanced algorithms
-    
-    The package demonstrates the performance difference between pure Python
-    implementations and C++ accelerated versions of the same algorithms.
-    """,
-    ext_modules=ext_modules,
-    cmdclass={"build_ext": build_ext},
-    zip_safe=False,
-    python_requires=">=3.6",
-    install_requires=[
-        "pybind11>=2.6.0",
-        "numpy>=1.18.0",
-    ],
-    classifiers=[
-        "Development Status :: 4 - Beta",
-        "Intended Audience :: Developers",
-        "License :: OSI Approved :: MIT License",
-        "Programming Language :: Python :: 3",
-        "Programming Language :: Python :: 3.6",
-        "Programming Language :: Python :: 3.7",
-        "Programming Language :: Python :: 3.8", 
-        "Programming Language :: Python :: 3.9",
-        "Programming Language :: Python :: 3.10",
-        "Programming Language :: Python :: 3.11",
-        "Programming Language :: C++",
-        "Topic :: Software Development :: Libraries :: Python Modules",
-        "Topic :: Scientific/Engineering",
-        "Topic :: System :: Hardware",
-    ],
+"""
+Setup script for building the C++ accelerated Python extension.
+This script uses pybind11 to create a Python module from C++ code.
+"""
+
+import os
+import sysconfig
+
+from setuptools import setup, Extension
+from pybind11.setup_helpers import Pybind11Extension, build_ext
+from pybind11 import get_cmake_dir
+import pybind11
+
+
+def optimization_flags():
+    """
+    Profile-guided and link-time optimization flags, driven by `make build-pgo`:
+    CPP_ACCELERATED_PGO=generate builds an instrumented module that writes
+    profiles to CPP_ACCELERATED_PROFILE_DIR; =use rebuilds from them, and
+    CPP_ACCELERATED_LTO=1 adds -flto. Returns (compile_args, link_args).
+    """
+    compiler = os.environ.get("CXX") or os.environ.get("CC") or sysconfig.get_config_var("CC") or ""
+    clang = "clang" in compiler
+    profile_dir = os.path.abspath(os.environ.get("CPP_ACCELERATED_PROFILE_DIR", "build/pgo-profile"))
+    mode = os.environ.get("CPP_ACCELERATED_PGO", "")
+    flags = []
+    if mode == "generate":
+        # Kernels run on the thread pool, so counters must be updated atomically
+        flags += ["-fprofile-generate=" + profile_dir, "-fprofile-update=atomic"]
+    elif mode == "use":
+        if clang:
+            # Raw profiles are merged by llvm-profdata first (see Makefile)
+            flags += ["-fprofile-use=" + os.path.join(profile_dir, "default.profdata")]
+        else:
+            # Keep kernels the training run missed optimized for speed, not size
+            flags += ["-fprofile-use=" + profile_dir, "-fprofile-partial-training",
+                      "-Wno-missing-profile"]
+    elif mode:
+        raise ValueError("CPP_ACCELERATED_PGO must be 'generate' or 'use', not %r" % mode)
+    if os.environ.get("CPP_ACCELERATED_LTO") == "1":
+        flags += ["-flto"] if clang else ["-flto=auto"]
+    return flags, list(flags)
+
+
+compile_args, link_args = optimization_flags()
+
+# Define the extension module
+ext_modules = [
+    Pybind11Extension(
+        "cpp_accelerated",  # Module name
+        sources=[
+            "pybind_wrapper.cpp",
+            "cpp_functions.cpp",
+            "segmented_sieve.cpp",
+            "prime_pi.cpp",
+            "wheel_sieve.cpp",
+            "fibonacci.cpp",
+            "batch.cpp",
+            "gemm.cpp",
+            "thread_pool.cpp",
+            "cancellation.cpp",
+            "bench.cpp",
+            "perf_counters.cpp",
+            "metrics.cpp",
+            "cpu_features.cpp",
+            "scratch.cpp",
+            "prime_table.cpp",
+            "primality.cpp",
+        ],
+        include_dirs=[
+            # Path to pybind11 headers
+            pybind11.get_include(),
+        ],
+        language='c++',
+        cxx_std=17,  # C++17 standard
+        # No -arch/-march: wider ISAs are picked at import (cpu_features.h),
+        # so one build runs on any CPU of its architecture
+        define_macros=[('VERSION_INFO', '"dev"')],
+        extra_compile_args=compile_args,
+        extra_link_args=link_args,
+    ),
+]
+
+setup(
+    name="cpp_accelerated",
+    version="1.0.0",
+    author="Python C++ Performance Comparison",
+    author_email="",
+    description="C++ accelerated functions for Python performance comparison",
+    long_description="""
+    This package provides C++ implementations of computationally intensive functions
+    that can be called from Python for significant performance improvements.
+    
+    Features:
+    - Sum of squares calculation
+    - Fibonacci sequence generation
+    - Prime number counting
+    - Matrix multiplication
+    - Optimized versions using advanced algorithms
+    
+    The package demonstrates the performance difference between pure Python
+    implementations and C++ accelerated versions of the same algorithms.
+    """,
+    ext_modules=ext_modules,
+    cmdclass={"build_ext": build_ext},
+    zip_safe=False,
+    python_requires=">=3.6",
+    install_requires=[
+        "pybind11>=2.6.0",
+        "numpy>=1.18.0",
+    ],
+    classifiers=[
+        "Development Status :: 4 - Beta",
+        "Intended Audience :: Developers",
+        "License :: OSI Approved :: MIT License",
+        "Programming Language :: Python :: 3",
+        "Programming Language :: Python :: 3.6",
+        "Programming Language :: Python :: 3.7",
+        "Programming Language :: Python :: 3.8", 
+        "Programming Language :: Python :: 3.9",
+        "Programming Language :: Python :: 3.10",
+        "Programming Language :: Python :: 3.11",
+        "Programming Language :: C++",
+        "Topic :: Software Development :: Libraries :: Python Modules",
+        "Topic :: Scientific/Engineering",
+        "Topic :: System :: Hardware",
+    ],
 )
\ No newline at end of file
@@ -0,0 +1,126 @@
+#ifndef SMALL_TABLES_H
+#define SMALL_TABLES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Lookup tables built entirely at compile time, so the smallest inputs of
+ * the Fibonacci and prime kernels are answered without computing anything:
+ * every Fibonacci number that fits in a long long, and a one-bit-per-odd
+ * primality bitmap of [0, 65536] with running counts for pi(x).
+ */
+
+namespace cpp_functions {
+namespace small {
+
+/** F(92) is the largest Fibonacci number that fits in a long long. */
+constexpr int kFibonacciMax = 92;
+
+constexpr std::array<long long, kFibonacciMax + 1> make_fibonacci_table() {
+    std::array<long long, kFibonacciMax + 1> table{};
+    table[1] = 1;
+    for (int n = 2; n <= kFibonacciMax; ++n) {
+        table[n] = table[n - 1] + table[n - 2];
+    }
+    return table;
+}
+
+/** F(0) .. F(92). */
+inline constexpr std::array<long long, kFibonacciMax + 1> kFibonacci = make_fibonacci_table();
+
+/** Largest value the prime bitmap covers. */
+constexpr std::uint32_t kPrimeTableLimit = 65536;
+
+/**
+ * Bit i of bits is set when 2i + 1 is prime; prefix[w] counts the set bits
+ * before word w.
+ */
+struct PrimeTable {
+    static constexpr std::size_t kWords = kPrimeTableLimit / 128;
+
+    std::uint64_t bits[kWords] = {};
+    std::uint16_t prefix[kWords] = {};
+
+    constexpr bool is_prime(std::uint32_t n) const {
+        if (n < 3) {
+            return n == 2;
+        }
+        return n % 2 == 1 && ((bits[n / 128] >> (n / 2 % 64)) & 1) != 0;
+    }
+
+    /** Primes <= n, for n <= kPrimeTableLimit. */
+    constexpr std::uint32_t count(std::uint32_t n) const {
+        if (n < 2) {
+            return 0;
+        }
+        // Odd numbers 1, 3, ..., n map to bit indices 0 .. (n - 1) / 2
+        const std::uint32_t i = (n - 1) / 2;
+        const std::uint64_t mask = (std::uint64_t(2) << (i % 64)) - 1;
+        return 1 + prefix[i / 64] + static_cast<std::uint32_t>(__builtin_popcountll(bits[i / 64] & mask));
+    }
+};
+
+constexpr PrimeTable make_prime_table() {
+    PrimeTable table;
+    for (std::size_t w = 0; w < PrimeTable::kWords; ++w) {
+        table.bits[w] = ~std::uint64_t(0);
+    }
+    table.bits[0] &= ~std::uint64_t(1);  // 1 is not prime
+    for (std::uint32_t p = 3; p * p <= kPrimeTableLimit; p += 2) {
+        if ((table.bits[p / 128] >> (p / 2 % 64)) & 1) {
+            for (std::uint32_t m = p * p; m <= kPrimeTableLimit; m += 2 * p) {
+                table.bits[m / 128] &= ~(std::uint64_t(1) << (m / 2 % 64));
+            }
+        }
+    }
+    std::uint16_t running = 0;
+    for (std::size_t w = 0; w < PrimeTable::kWords; ++w) {
+        table.prefix[w] = running;
+        running = static_cast<std::uint16_t>(running + __builtin_popcountll(table.bits[w]));
+    }
+    return table;
+}
+
+inline constexpr PrimeTable kPrimes = make_prime_table();
+
+static_assert(kFibonacci[kFibonacciMax] == 7540113804746346429LL, "Fibonacci table");
+static_assert(kPrimes.count(kPrimeTableLimit) == 6542, "prime table");
+
+/**
+ * Call f(2 i + 1) for every set bit i in [first, last) of an odd-only
+ * bitmap like PrimeTable::bits, in increasing order.
+ */
+template <typename U, typename F>
+void for_each_odd_bit(const std::uint64_t* bits, U first, U last, F&& f) {
+    for (U w = first / 64; w * 64 < last; ++w) {
+        std::uint64_t word = bits[w];
+        if (w == first / 64) {
+            word &= ~std::uint64_t(0) << (first % 64);
+        }
+        if ((w + 1) * 64 > last) {
+            word &= (std::uint64_t(1) << (last % 64)) - 1;
+        }
+        while (word) {
+            f(2 * (w * 64 + static_cast<U>(__builtin_ctzll(word))) + 1);
+            word &= word - 1;
+        }
+    }
+}
+
+/** Primes in [lo, hi], hi <= kPrimeTableLimit, in increasing order. */
+template <typename F>
+void for_each_prime(std::uint32_t lo, std::uint32_t hi, F&& f) {
+    if (lo <= 2 && hi >= 2) {
+        f(std::uint32_t(2));
+    }
+    const std::uint32_t first = lo < 3 ? 1 : lo / 2;          // bit of the first odd >= lo
+    const std::uint32_t last = hi < 3 ? 0 : (hi - 1) / 2 + 1; // one past the last odd <= hi
+    for_each_odd_bit(kPrimes.bits, first, last, f);
+}
+
+} // namespace small
+} // namespace cpp_functions
+
+#endif // SMALL_TABLES_H
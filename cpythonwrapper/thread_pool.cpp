@@ -0,0 +1,392 @@
+#include "thread_pool.h"
+
+#include "cancellation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/**
+ * Shared thread pool.
+ * Tasks are pushed to the deque of the worker that submits them (or round
+ * robin from outside the pool) and popped LIFO by their owner, which keeps
+ * nested work on a warm cache; thieves take the oldest task FIFO.
+ */
+
+namespace cpp_functions {
+
+namespace {
+
+/** Allowed CPU ids, in order; empty when the platform cannot report them. */
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+void pin_current_thread(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;  // no portable affinity API; workers stay unpinned
+#endif
+}
+
+/**
+ * A pool of one thread runs parallel loops on the caller alone, but still
+ * has one queue: its worker starts on the first submit() and then serves
+ * every task submitted to the pool.
+ */
+class Pool {
+public:
+    Pool(unsigned threads, bool pin)
+        : threads_(std::max(threads, 1u)), queues_(std::max(threads_ - 1, 1u)), pinned_(pin) {
+        for (auto& queue : queues_) {
+            queue.reset(new Queue());
+        }
+        cpus_ = pin ? allowed_cpus() : std::vector<int>();
+        workers_.reserve(queues_.size());
+        if (threads_ > 1) {
+            for (std::size_t i = 0; i < queues_.size(); ++i) {
+                start_worker(i);
+            }
+        }
+    }
+
+    ~Pool() { shutdown(); }
+
+    /** Let the workers drain their queues, then join them. */
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    unsigned size() const { return threads_; }
+    bool pinned() const { return pinned_; }
+
+    /**
+     * Queue task for a worker. Once shutdown() has begun the pool takes
+     * nothing more: task is left untouched and false is returned.
+     */
+    bool submit(std::function<void()>& task) {
+        std::size_t target = (current_pool == this) ? current_index
+                                                    : next_queue_++ % queues_.size();
+        {
+            // Workers decide to exit under the sleep mutex, so a task queued
+            // while holding it is drained before they do
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            if (stopping_) {
+                return false;
+            }
+            if (workers_.empty()) {
+                start_worker(0);
+            }
+            {
+                std::lock_guard<std::mutex> queue_lock(queues_[target]->mutex);
+                queues_[target]->tasks.push_back(std::move(task));
+            }
+            pending_.fetch_add(1, std::memory_order_release);
+        }
+        wake_.notify_one();
+        return true;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void start_worker(std::size_t i) {
+        // CPU 0 of the mask is left to the calling thread
+        int cpu = cpus_.empty() ? -1 : cpus_[(i + 1) % cpus_.size()];
+        workers_.emplace_back([this, i, cpu] {
+            if (cpu >= 0) {
+                pin_current_thread(cpu);
+            }
+            run_worker(i);
+        });
+    }
+
+    bool pop_own(std::size_t i, std::function<void()>& task) {
+        Queue& queue = *queues_[i];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(std::size_t thief, std::function<void()>& task) {
+        for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+            Queue& queue = *queues_[(thief + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run_worker(std::size_t i) {
+        current_pool = this;
+        current_index = i;
+        std::function<void()> task;
+        for (;;) {
+            if (pop_own(i, task) || steal(i, task)) {
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] {
+                return stopping_ || pending_.load(std::memory_order_acquire) > 0;
+            });
+            if (stopping_ && pending_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    static thread_local Pool* current_pool;
+    static thread_local std::size_t current_index;
+
+    unsigned threads_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;  // started lazily when threads_ == 1
+    std::vector<int> cpus_;
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> next_queue_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    bool pinned_;
+};
+
+thread_local Pool* Pool::current_pool = nullptr;
+thread_local std::size_t Pool::current_index = 0;
+
+// Pool configuration; g_pool is created lazily from the requested size
+std::mutex g_config_mutex;
+std::shared_ptr<Pool> g_pool;
+unsigned g_requested = 0;
+bool g_pin = false;
+std::once_flag g_atfork_once;
+
+unsigned default_threads() {
+    if (const char* env = std::getenv("CPP_ACCELERATED_NUM_THREADS")) {
+        long value = std::strtol(env, nullptr, 10);
+        if (value > 0) {
+            return static_cast<unsigned>(value);
+        }
+    }
+    return hardware_threads();
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+void before_fork() { g_config_mutex.lock(); }
+void after_fork_parent() { g_config_mutex.unlock(); }
+void after_fork_child() {
+    // The workers did not survive the fork; leak the pool rather than join
+    // threads that do not exist, and start a fresh one on first use
+    new std::shared_ptr<Pool>(std::move(g_pool));
+    g_config_mutex.unlock();
+}
+#endif
+
+std::shared_ptr<Pool> acquire_pool() {
+    std::call_once(g_atfork_once, [] {
+#if defined(__unix__) || defined(__APPLE__)
+        pthread_atfork(before_fork, after_fork_parent, after_fork_child);
+#endif
+    });
+    std::lock_guard<std::mutex> lock(g_config_mutex);
+    if (!g_pool) {
+        g_pool = std::make_shared<Pool>(g_requested ? g_requested : default_threads(), g_pin);
+    }
+    return g_pool;
+}
+
+/**
+ * Progress of one parallel_for. Helpers hold a reference, so one that
+ * starts after the loop has finished only sees next >= count and leaves.
+ */
+struct LoopState {
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+    std::size_t count = 0;
+    const std::function<void(std::size_t)>* body = nullptr;
+    CancellationToken* token = nullptr;  // the caller's, installed on helpers
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+void run_indices(LoopState& state) {
+    CancellationScope scope(state.token);
+    for (;;) {
+        std::size_t i = state.next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= state.count) {
+            return;
+        }
+        if (!state.failed.load(std::memory_order_relaxed)) {
+            try {
+                (*state.body)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (!state.error) {
+                    state.error = std::current_exception();
+                }
+                state.failed.store(true, std::memory_order_relaxed);
+            }
+        }
+        if (state.done.fetch_add(1, std::memory_order_acq_rel) + 1 == state.count) {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.finished.notify_all();
+        }
+    }
+}
+
+} // namespace
+
+unsigned hardware_threads() {
+    std::size_t allowed = allowed_cpus().size();
+    if (allowed > 0) {
+        return static_cast<unsigned>(allowed);
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void set_num_threads(unsigned threads, bool pin) {
+    std::shared_ptr<Pool> old;
+    {
+        std::lock_guard<std::mutex> lock(g_config_mutex);
+        g_requested = threads;
+        g_pin = pin;
+        old = std::move(g_pool);
+    }
+    if (old) {
+        old->shutdown();
+    }
+}
+
+unsigned get_num_threads() {
+    return acquire_pool()->size();
+}
+
+bool threads_pinned() {
+    return acquire_pool()->pinned();
+}
+
+unsigned resolve_threads(unsigned threads) {
+    unsigned available = get_num_threads();
+    return threads == 0 ? available : std::min(threads, available);
+}
+
+void parallel_for(std::size_t count, unsigned max_threads,
+                  const std::function<void(std::size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    std::shared_ptr<Pool> pool;
+    unsigned threads = 1;
+    if (count > 1 && max_threads != 1) {
+        pool = acquire_pool();
+        threads = max_threads == 0 ? pool->size() : std::min(max_threads, pool->size());
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, count));
+    }
+    if (threads <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    auto state = std::make_shared<LoopState>();
+    state->count = count;
+    state->body = &body;
+    state->token = current_cancellation_token();
+    for (unsigned t = 1; t < threads; ++t) {
+        // A pool being replaced refuses helpers; the caller runs their share
+        std::function<void()> helper = [state] { run_indices(*state); };
+        if (!pool->submit(helper)) {
+            break;
+        }
+    }
+    run_indices(*state);
+    {
+        // While helpers finish, keep polling the token (e.g. for Ctrl-C) so
+        // a cancelled loop skips the indices nobody has claimed yet
+        std::unique_lock<std::mutex> lock(state->mutex);
+        auto all_done = [&] { return state->done.load(std::memory_order_acquire) == count; };
+        while (!state->finished.wait_for(lock, std::chrono::milliseconds(10), all_done)) {
+            if (state->token) {
+                lock.unlock();
+                if (state->token->stop_requested()) {
+                    state->failed.store(true, std::memory_order_relaxed);
+                }
+                lock.lock();
+            }
+        }
+    }
+    // Take the error out of the shared state: a helper may drop the last
+    // reference to it while the exception is still being handled here
+    std::exception_ptr error = std::move(state->error);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (state->failed.load(std::memory_order_relaxed)) {
+        state->token->check();
+    }
+}
+
+void submit(std::function<void()> task) {
+    // A pool refuses tasks once set_num_threads() has swapped it out; by
+    // then acquire_pool() returns its replacement
+    while (!acquire_pool()->submit(task)) {
+    }
+}
+
+} // namespace cpp_functions
@@ -0,0 +1,69 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Process-wide work-stealing thread pool shared by every parallel kernel.
+ * Workers start on first use and each owns a task deque; an idle worker
+ * steals from the front of the others. The calling thread always takes
+ * part in the work, so a pool of N threads runs N - 1 workers. In a child
+ * created by fork() the pool is discarded and restarted on first use, so
+ * preforked servers never wait on threads that only exist in the parent.
+ */
+
+namespace cpp_functions {
+
+/**
+ * Number of CPUs this process may run on, honouring its affinity mask.
+ */
+unsigned hardware_threads();
+
+/**
+ * Resize the shared pool to threads threads, caller included; 0 restores the
+ * default (CPP_ACCELERATED_NUM_THREADS if set, else hardware_threads()).
+ * pin binds worker i to the (i + 1)-th allowed CPU where the platform
+ * supports it. Work already running finishes on the old workers.
+ */
+void set_num_threads(unsigned threads, bool pin = false);
+
+/**
+ * Threads (caller included) a parallel kernel uses when asked for all cores.
+ */
+unsigned get_num_threads();
+
+/**
+ * True when the pool's workers are pinned to CPUs.
+ */
+bool threads_pinned();
+
+/**
+ * Map a kernel's threads argument to a thread count: 0 means
+ * get_num_threads(), anything else is capped at it.
+ */
+unsigned resolve_threads(unsigned threads);
+
+/**
+ * Call body(i) for every i in [0, count) on up to max_threads threads of
+ * the shared pool (resolved as by resolve_threads), the caller included.
+ * Indices are claimed dynamically. Blocks until every call has returned;
+ * the first exception thrown by body is rethrown and the remaining indices
+ * are skipped. Safe to nest: a caller never waits for helpers that have
+ * not started, it runs the remaining indices itself.
+ */
+void parallel_for(std::size_t count, unsigned max_threads,
+                  const std::function<void(std::size_t)>& body);
+
+/**
+ * Run task on a pool worker without waiting for it. A one-thread pool
+ * starts a single worker for submitted tasks on first use, so a task never
+ * runs on the caller. Tasks submitted while set_num_threads() replaces the
+ * pool go to the new one. Exceptions escaping task terminate the process;
+ * callers report errors through their own channel.
+ */
+void submit(std::function<void()> task);
+
+} // namespace cpp_functions
+
+#endif // THREAD_POOL_H
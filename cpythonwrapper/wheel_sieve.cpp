@@ -0,0 +1,235 @@
+#include "wheel_sieve.h"
+#include "segmented_sieve.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "cancellation.h"
+#include "cpu_features.h"
+
+/**
+ * Bit-packed mod-30 wheel sieve.
+ * A multiple p * m of a base prime p is only stored when m is coprime to 30,
+ * so for each of the 8 residues of m the multiples form a progression that
+ * advances p bytes at a time and always lands on the same bit.
+ */
+
+namespace cpp_functions {
+namespace sieve {
+
+namespace {
+
+constexpr std::uint8_t kResidues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+
+/** Bit index of each residue mod 30, or -1 when it shares a factor with 30. */
+constexpr std::int8_t kResidueBit[30] = {
+    -1, 0, -1, -1, -1, -1, -1, 1, -1, -1, -1, 2, -1, 3, -1,
+    -1, -1, 4, -1, 5, -1, -1, -1, 6, -1, -1, -1, -1, -1, 7};
+
+/** Bits of a single byte whose values are >= offset (0-29) within it. */
+std::uint8_t bits_from(std::uint64_t offset) {
+    std::uint8_t mask = 0;
+    for (int b = 0; b < 8; ++b) {
+        if (kResidues[b] >= offset) {
+            mask |= static_cast<std::uint8_t>(1u << b);
+        }
+    }
+    return mask;
+}
+
+/** Bits of a single byte whose values are <= offset (0-29) within it. */
+std::uint8_t bits_through(std::uint64_t offset) {
+    std::uint8_t mask = 0;
+    for (int b = 0; b < 8; ++b) {
+        if (kResidues[b] <= offset) {
+            mask |= static_cast<std::uint8_t>(1u << b);
+        }
+    }
+    return mask;
+}
+
+/**
+ * Set bits in bits[0, len). x86 baseline builds have no POPCNT instruction
+ * and expand __builtin_popcountll into a bit-twiddling sequence, so the
+ * loop is also compiled inside a popcnt-targeted wrapper that inherits it.
+ */
+inline __attribute__((always_inline)) std::uint64_t popcount_bytes(const std::uint8_t* bits,
+                                                                     std::size_t len) {
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bits + i, sizeof(word));
+        total += static_cast<std::uint64_t>(__builtin_popcountll(word));
+    }
+    for (; i < len; ++i) {
+        total += static_cast<std::uint64_t>(__builtin_popcount(bits[i]));
+    }
+    return total;
+}
+
+std::uint64_t popcount_generic(const std::uint8_t* bits, std::size_t len) {
+    return popcount_bytes(bits, len);
+}
+
+#if defined(CPP_FUNCTIONS_X86)
+CPP_FUNCTIONS_TARGET_SSE42 std::uint64_t popcount_sse42(const std::uint8_t* bits, std::size_t len) {
+    return popcount_bytes(bits, len);
+}
+#endif
+
+using PopcountFn = std::uint64_t (*)(const std::uint8_t*, std::size_t);
+
+PopcountFn popcount_kernel() {
+#if defined(CPP_FUNCTIONS_X86)
+    static const PopcountFn kernel = simd_path() == SimdPath::generic ? popcount_generic : popcount_sse42;
+#else
+    static const PopcountFn kernel = popcount_generic;
+#endif
+    return kernel;
+}
+
+} // namespace
+
+WheelSieve::WheelSieve(std::uint64_t lo, std::uint64_t hi,
+                       const std::vector<std::uint32_t>& primes,
+                       std::size_t segment_bytes)
+    : lo_(lo), hi_(hi) {
+    const std::uint64_t small[3] = {2, 3, 5};
+    for (std::uint64_t p : small) {
+        if (lo <= p && p <= hi) {
+            ++small_primes_;
+        }
+    }
+    small_pending_ = small_primes_ > 0;
+    if (hi < lo || hi < 7) {
+        return;
+    }
+
+    first_byte_ = lo / 30;
+    byte_count_ = hi / 30 - first_byte_ + 1;
+    if (segment_bytes == 0) {
+        // One byte per 30 integers: aim for a segment spanning sqrt(hi)
+        segment_bytes = std::min<std::size_t>(
+            std::max<std::size_t>(static_cast<std::size_t>(isqrt(hi) / 30), kL1SegmentBytes),
+            kL2SegmentBytes);
+    }
+    segment_ = scratch::Array<std::uint8_t>(static_cast<std::size_t>(
+        std::min<std::uint64_t>(segment_bytes, byte_count_)));
+
+    std::uint64_t root = isqrt(hi);
+    for (std::uint32_t p : primes) {
+        if (p > root) {
+            break;
+        }
+        if (p >= 7) {
+            primes_.push_back(p);
+        }
+    }
+
+    next_ = scratch::Array<std::uint64_t>(primes_.size() * 8);
+    masks_ = scratch::Array<std::uint8_t>(primes_.size() * 8);
+    for (std::size_t k = 0; k < primes_.size(); ++k) {
+        std::uint64_t p = primes_[k];
+        // Smallest multiplier giving a multiple >= max(p * p, lo)
+        std::uint64_t m_start = std::max<std::uint64_t>(p, (lo + p - 1) / p);
+        for (int r = 0; r < 8; ++r) {
+            std::uint64_t m = m_start + (kResidues[r] + 30 - m_start % 30) % 30;
+            std::uint64_t value = p * m;
+            next_[k * 8 + r] = value / 30;
+            masks_[k * 8 + r] = static_cast<std::uint8_t>(1u << kResidueBit[value % 30]);
+        }
+    }
+}
+
+bool WheelSieve::next() {
+    emit_small_ = small_pending_;
+    small_pending_ = false;
+    if (position_ >= byte_count_) {
+        segment_len_ = 0;
+        return emit_small_;
+    }
+    cancellation_point();
+
+    std::size_t len = static_cast<std::size_t>(
+        std::min<std::uint64_t>(segment_.size(), byte_count_ - position_));
+    std::uint64_t start = first_byte_ + position_;
+    std::uint64_t end = start + len;
+    std::uint64_t segment_high = 30 * end - 1;
+
+    while (active_ < primes_.size() &&
+           static_cast<std::uint64_t>(primes_[active_]) * primes_[active_] <= segment_high) {
+        ++active_;
+    }
+
+    std::uint8_t* bits = segment_.data();
+    std::memset(bits, 0xFF, len);
+    for (std::size_t k = 0; k < active_; ++k) {
+        const std::uint64_t p = primes_[k];
+        std::uint64_t* next = &next_[k * 8];
+        const std::uint8_t* masks = &masks_[k * 8];
+        for (int r = 0; r < 8; ++r) {
+            std::uint64_t j = next[r];
+            if (j >= end) {
+                continue;
+            }
+            const std::uint8_t clear = static_cast<std::uint8_t>(~masks[r]);
+            for (j -= start; j < len; j += p) {
+                bits[j] &= clear;
+            }
+            next[r] = start + j;
+        }
+    }
+
+    // Trim values outside [lo, hi] and the non-prime 1
+    if (position_ == 0) {
+        bits[0] &= bits_from(lo_ - 30 * first_byte_);
+        if (first_byte_ == 0) {
+            bits[0] &= static_cast<std::uint8_t>(~1u);
+        }
+    }
+    if (end == first_byte_ + byte_count_) {
+        bits[len - 1] &= bits_through(hi_ - 30 * (end - 1));
+    }
+
+    segment_len_ = len;
+    position_ += len;
+    return true;
+}
+
+std::uint64_t WheelSieve::count() const {
+    const std::uint64_t small = emit_small_ ? small_primes_ : 0;
+    return small + popcount_kernel()(segment_.data(), segment_len_);
+}
+
+const char* popcount_kernel_name() {
+#if defined(CPP_FUNCTIONS_X86)
+    return popcount_kernel() == popcount_generic ? "generic" : "popcnt";
+#elif defined(CPP_FUNCTIONS_AARCH64)
+    return "neon";  // __builtin_popcountll is a CNT instruction there
+#else
+    return "generic";
+#endif
+}
+
+std::uint64_t count_primes_wheel(std::uint64_t lo, std::uint64_t hi,
+                                 unsigned threads) {
+    if (hi < lo) {
+        return 0;
+    }
+    const std::vector<std::uint32_t> primes = base_primes(hi);
+    // Chunk boundaries fall on whole wheel segments (30 integers per byte)
+    const std::uint64_t span = 30 * static_cast<std::uint64_t>(kL2SegmentBytes);
+    return parallel_count(lo, hi, threads, span,
+                          [&primes](std::uint64_t chunk_lo, std::uint64_t chunk_hi) {
+        WheelSieve sieve(chunk_lo, chunk_hi, primes);
+        std::uint64_t total = 0;
+        while (sieve.next()) {
+            total += sieve.count();
+        }
+        return total;
+    });
+}
+
+} // namespace sieve
+} // namespace cpp_functions